@@ -18,12 +18,21 @@
 #include "adv_network_rx.h"
 #include "adv_network_tx.h"
 #include "adv_network_kernels.h"
+#include "adv_network_cpu_reorder.h"
 #include "holoscan/holoscan.hpp"
 #include <linux/if_ether.h>
 #include <linux/ip.h>
 #include <linux/udp.h>
 #include <arpa/inet.h>
 #include <assert.h>
+#include <chrono>
+#include <cmath>
+#include <endian.h>
+#include <random>
+#include <unistd.h>
+#include <map>
+#include <memory>
+#include <vector>
 
 
 namespace holoscan::ops {
@@ -36,18 +45,194 @@ struct UDPIPV4Pkt {
   uint8_t payload[];
 } __attribute__((packed));
 
+// Where the transmitter stamps each payload when sequence numbers and timestamps are enabled
+static constexpr int SEQ_OFFSET = 0;
+static constexpr int TIMESTAMP_OFFSET = 4;
+
+// Clock the transmitter stamps payloads with. Realtime compares across hosts whose clocks are
+// synchronized, such as with PTP. Monotonic is TSC-based on Linux and only compares on one host.
+enum class BenchClock {
+  NONE,
+  REALTIME,
+  MONOTONIC,
+};
+
+static bool ParseBenchClock(const std::string &name, BenchClock &clock) {
+  if (name == "none") {
+    clock = BenchClock::NONE;
+  } else if (name == "realtime") {
+    clock = BenchClock::REALTIME;
+  } else if (name == "monotonic") {
+    clock = BenchClock::MONOTONIC;
+  } else {
+    HOLOSCAN_LOG_CRITICAL("Invalid timestamps {}; must be none, realtime or monotonic", name);
+    return false;
+  }
+
+  return true;
+}
+
+// How the transmitter builds its packets. With a template the headers of each queue's flow are
+// built once and copied into every packet, and attach sends the payloads without copying them.
+enum class BenchTemplate {
+  NONE,
+  COPY,
+  ATTACH,
+};
+
+static bool ParseBenchTemplate(const std::string &name, BenchTemplate &tmpl) {
+  if (name == "none") {
+    tmpl = BenchTemplate::NONE;
+  } else if (name == "copy") {
+    tmpl = BenchTemplate::COPY;
+  } else if (name == "attach") {
+    tmpl = BenchTemplate::ATTACH;
+  } else {
+    HOLOSCAN_LOG_CRITICAL("Invalid header_template {}; must be none, copy or attach", name);
+    return false;
+  }
+
+  return true;
+}
+
+static int64_t BenchClockNs(BenchClock clock) {
+  const auto now = clock == BenchClock::REALTIME ?
+      std::chrono::system_clock::now().time_since_epoch() :
+      std::chrono::steady_clock::now().time_since_epoch();
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(now).count();
+}
+
+// Latencies bucketed with 1/16 relative precision, so percentiles need no per-packet storage
+class LatencyHistogram {
+ public:
+  void Add(int64_t ns) {
+    const uint64_t v = std::max<int64_t>(ns, 0);
+    buckets_[Bucket(v)]++;
+    count_++;
+    max_ = std::max(max_, v);
+  }
+
+  uint64_t Count() const { return count_; }
+  uint64_t Max() const { return max_; }
+
+  // Upper bound of the bucket holding the pct percentile
+  uint64_t Percentile(double pct) const {
+    const uint64_t rank = std::max<uint64_t>(1, std::ceil(pct / 100 * count_));
+    uint64_t seen = 0;
+    for (size_t b = 0; b < buckets_.size(); b++) {
+      seen += buckets_[b];
+      if (seen >= rank) {
+        return std::min(max_, BucketMax(b));
+      }
+    }
+
+    return max_;
+  }
+
+ private:
+  static constexpr int SUB_BITS = 4;
+  static constexpr uint64_t SUB_BUCKETS = 1 << SUB_BITS;
+
+  static size_t Bucket(uint64_t v) {
+    if (v < SUB_BUCKETS) {
+      return v;
+    }
+
+    const int exp = 63 - __builtin_clzll(v);
+    return (exp - SUB_BITS + 1) * SUB_BUCKETS + ((v >> (exp - SUB_BITS)) & (SUB_BUCKETS - 1));
+  }
+
+  static uint64_t BucketMax(size_t b) {
+    if (b < SUB_BUCKETS) {
+      return b;
+    }
+
+    const int shift = b / SUB_BUCKETS - 1;
+    return ((SUB_BUCKETS + b % SUB_BUCKETS + 1) << shift) - 1;
+  }
+
+  std::array<uint64_t, 64 * SUB_BUCKETS> buckets_{};
+  uint64_t count_ = 0;
+  uint64_t max_ = 0;
+};
+
 class AdvNetworkingBenchTxOp : public Operator {
  public:
   HOLOSCAN_OPERATOR_FORWARD_ARGS(AdvNetworkingBenchTxOp)
 
   AdvNetworkingBenchTxOp() = default;
 
+  ~AdvNetworkingBenchTxOp() {
+    if (ttl_pkts_sent_ == 0) {
+      return;
+    }
+
+    auto secs = std::chrono::duration<double>(last_burst_ - first_burst_).count();
+    HOLOSCAN_LOG_INFO("Finished transmitter with {}/{} bytes/packets sent", ttl_bytes_sent_,
+        ttl_pkts_sent_);
+    if (secs > 0) {
+      HOLOSCAN_LOG_INFO("Transmit rate: {:.0f} packets/s, {:.2f} Gbps", ttl_pkts_sent_ / secs,
+          ttl_bytes_sent_ * 8 / secs / 1e9);
+    }
+
+    if (cksum_ns_ > 0) {
+      HOLOSCAN_LOG_INFO("Software checksums: {:.1f} ns/packet, {:.2f} GB/s",
+          static_cast<double>(cksum_ns_) / ttl_pkts_sent_,
+          static_cast<double>(ttl_bytes_sent_) / cksum_ns_);
+    }
+
+    if (build_ns_ > 0) {
+      HOLOSCAN_LOG_INFO("Header template ({}): {:.1f} ns/packet",
+          tmpl_mode_ == BenchTemplate::COPY ? "copy" : "attach",
+          static_cast<double>(build_ns_) / ttl_pkts_sent_);
+    }
+  }
+
   void initialize() override {
     HOLOSCAN_LOG_INFO("AdvNetworkingBenchTxOp::initialize()");
     holoscan::Operator::initialize();
 
+    if (!ParseBenchClock(timestamps_.get(), clock_) ||
+        !ParseBenchTemplate(header_template_.get(), tmpl_mode_)) {
+      return;
+    }
+
+    // Attached payloads are sent as they are, and a template computes its own checksums
+    if (tmpl_mode_ == BenchTemplate::ATTACH && (seq_numbers_.get() || clock_ != BenchClock::NONE)) {
+      HOLOSCAN_LOG_CRITICAL("Attached payloads cannot carry sequence numbers or timestamps");
+      return;
+    }
+
+    if (tmpl_mode_ != BenchTemplate::NONE && time_checksums_.get()) {
+      HOLOSCAN_LOG_CRITICAL("time_checksums only applies without a header template");
+      return;
+    }
+
+    // The smallest payload must still hold the sequence number and timestamp
+    const size_t min_size = clock_ != BenchClock::NONE ? TIMESTAMP_OFFSET + sizeof(int64_t) :
+                            seq_numbers_.get() ? SEQ_OFFSET + sizeof(uint32_t) : 0;
+    const uint16_t smallest = min_payload_size_.get() > 0 ?
+        std::min(min_payload_size_.get(), payload_size_.get()) : payload_size_.get();
+    if (smallest < min_size) {
+      HOLOSCAN_LOG_CRITICAL("Payloads must be at least {} bytes to hold a sequence number and "
+          "timestamp", min_size);
+      return;
+    }
+
     size_t buf_size = batch_size_.get() * payload_size_.get();
-    cudaMallocHost(&full_batch_data_h_, buf_size);
+    if (tmpl_mode_ == BenchTemplate::ATTACH) {
+      // The NIC reads attached payloads straight from this buffer, so it is mapped for DMA. It is
+      // never written after this, so every burst can attach it while earlier ones are in flight.
+      const size_t page = sysconf(_SC_PAGESIZE);
+      buf_size = (buf_size + page - 1) / page * page;
+      full_batch_data_h_ = aligned_alloc(page, buf_size);
+      if (adv_net_register_tx_memory(full_batch_data_h_, buf_size) != AdvNetStatus::SUCCESS) {
+        HOLOSCAN_LOG_CRITICAL("Failed to register the payload buffer for attached payloads");
+        return;
+      }
+    } else {
+      cudaMallocHost(&full_batch_data_h_, buf_size);
+    }
 
     // Fill in with increasing bytes
     uint8_t *cptr = static_cast<uint8_t*>(full_batch_data_h_);
@@ -66,6 +251,28 @@ class AdvNetworkingBenchTxOp : public Operator {
       "Batch size for each processing epoch", 1000);
     spec.param<uint16_t>(payload_size_, "payload_size", "Payload size",
       "Payload size to send. Does not include <= L4 headers", 1400);
+    spec.param<uint64_t>(num_bursts_, "num_bursts", "Number of bursts",
+      "Bursts to send before stopping. 0 sends until the application is stopped", 0);
+    spec.param<uint16_t>(num_queues_, "num_queues", "Number of queues",
+      "Bursts are spread round-robin over TX queues 0 to num_queues-1", 1);
+    spec.param<bool>(seq_numbers_, "sequence_numbers", "Sequence numbers",
+      "Start each payload with a 32-bit sequence number, counted per queue", false);
+    spec.param<std::string>(timestamps_, "timestamps", "Timestamps",
+      "Clock to stamp each payload with after the sequence number: none, realtime or monotonic",
+      "none");
+    spec.param<uint16_t>(min_payload_size_, "min_payload_size", "Minimum payload size",
+      "Payload sizes are uniformly distributed between this and payload_size. 0 sends only "
+      "payload_size", 0);
+    spec.param<double>(rate_gbps_, "rate_gbps", "Rate",
+      "Rate in Gbps to pace bursts to, including <= L4 headers. 0 sends as fast as possible", 0.0);
+    spec.param<uint32_t>(train_bursts_, "train_bursts", "Bursts per train",
+      "Bursts sent back to back before pacing waits, so traffic arrives in trains", 1);
+    spec.param<bool>(time_checksums_, "time_checksums", "Time checksums",
+      "Compute the checksums of each burst in software and time it, to measure the fallback "
+      "used on ports without checksum offload", false);
+    spec.param<std::string>(header_template_, "header_template", "Header template",
+      "Build packets from a per-queue header template: none writes each packet's headers, copy "
+      "copies the payloads in and attach sends them without a copy", "none");
   }
 
   void compute(InputContext&, OutputContext& op_output, ExecutionContext&) override {
@@ -76,7 +283,20 @@ class AdvNetworkingBenchTxOp : public Operator {
      * expect the transmit operator to operate much faster than the receiver since it's not having to do any work
      * to construct packets, and just copying from a buffer into memory.
     */
-    while (!adv_net_tx_burst_available(batch_size_.get())) {}
+    const uint16_t queue_id = next_queue_;
+    next_queue_ = (next_queue_ + 1) % std::max<uint16_t>(num_queues_.get(), 1);
+    while (!adv_net_tx_burst_available(batch_size_.get(), port_id, queue_id)) {}
+
+    // Each train starts when the previous ones would have finished at rate_gbps. A sender that
+    // falls behind starts the train now rather than catching up with a larger burst.
+    if (rate_gbps_.get() > 0 && train_pos_ == 0) {
+      auto now = std::chrono::steady_clock::now();
+      if (now < next_train_) {
+        while (std::chrono::steady_clock::now() < next_train_) {}
+      } else {
+        next_train_ = now;
+      }
+    }
 
     auto msg = CreateSharedBurstParams();
     adv_net_set_hdr(msg, port_id, queue_id, batch_size_);
@@ -86,26 +306,148 @@ class AdvNetworkingBenchTxOp : public Operator {
       return;
     }
 
-    void *pkt;
-    for (int num_pkt = 0; num_pkt < msg->hdr.num_pkts; num_pkt++) {
-      if ((ret = adv_net_set_cpu_udp_payload( msg,
-                                              num_pkt,
-                                              static_cast<char*>(full_batch_data_h_) +
-                                                    num_pkt * payload_size_.get(),
-                                              payload_size_.get())) != AdvNetStatus::SUCCESS) {
-        HOLOSCAN_LOG_ERROR("Failed to create packet {}", num_pkt);
+    // One timestamp per burst, taken when it is built rather than when it reaches the wire
+    const int64_t timestamp = htobe64(BenchClockNs(clock_));
+    int64_t burst_bytes = 0;
+    if (tmpl_mode_ != BenchTemplate::NONE) {
+      if (!BuildFromTemplate(msg, queue_id, timestamp, burst_bytes)) {
+        adv_net_free_pkts(msg->cpu_pkts, msg->hdr.num_pkts);
+        adv_net_free_tx_burst(msg);
+        return;
+      }
+    } else {
+      for (int num_pkt = 0; num_pkt < msg->hdr.num_pkts; num_pkt++) {
+        const uint16_t len = NextPayloadSize();
+        if ((ret = adv_net_set_cpu_udp_payload( msg,
+                                                num_pkt,
+                                                static_cast<char*>(full_batch_data_h_) +
+                                                      num_pkt * payload_size_.get(),
+                                                len)) != AdvNetStatus::SUCCESS) {
+          HOLOSCAN_LOG_ERROR("Failed to create packet {}", num_pkt);
+        }
+
+        auto pkt = static_cast<UDPIPV4Pkt*>(adv_net_get_cpu_pkt_ptr(msg, num_pkt));
+        if (seq_numbers_.get()) {
+          const uint32_t seq = htonl(next_seq_[queue_id]++);
+          memcpy(pkt->payload + SEQ_OFFSET, &seq, sizeof(seq));
+        }
+
+        if (clock_ != BenchClock::NONE) {
+          memcpy(pkt->payload + TIMESTAMP_OFFSET, &timestamp, sizeof(timestamp));
+        }
+
+        burst_bytes += len + sizeof(UDPIPV4Pkt);
       }
     }
 
+    if (time_checksums_.get()) {
+      const auto start = std::chrono::steady_clock::now();
+      adv_net_udp_checksum_burst(msg);
+      cksum_ns_ += std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now() - start).count();
+    }
+
+    if (rate_gbps_.get() > 0) {
+      next_train_ += std::chrono::nanoseconds(static_cast<int64_t>(burst_bytes * 8 /
+          rate_gbps_.get()));
+      train_pos_ = (train_pos_ + 1) % std::max<uint32_t>(train_bursts_.get(), 1);
+    }
+
+    last_burst_ = std::chrono::steady_clock::now();
+    if (ttl_pkts_sent_ == 0) {
+      first_burst_ = last_burst_;
+    }
+
+    ttl_pkts_sent_  += msg->hdr.num_pkts;
+    ttl_bytes_sent_ += burst_bytes;
     op_output.emit(msg, "burst_out");
   };
 
+
  private:
+  // Build a burst from the template of its queue, timing it
+  bool BuildFromTemplate(std::shared_ptr<AdvNetBurstParams> &msg, uint16_t queue_id,
+                         int64_t timestamp, int64_t &burst_bytes) {
+    auto tmpl = templates_.find(queue_id);
+    if (tmpl == templates_.end()) {
+      tmpl = templates_.emplace(queue_id, AdvNetUdpTemplate{}).first;
+      if (adv_net_create_udp_template(tmpl->second, port_id, queue_id) != AdvNetStatus::SUCCESS) {
+        HOLOSCAN_LOG_CRITICAL("Failed to create header template for queue {}", queue_id);
+        templates_.erase(tmpl);
+        return false;
+      }
+
+      tmpl->second.seq_offset = seq_numbers_.get() ? SEQ_OFFSET : -1;
+    }
+
+    const int64_t num_pkts = msg->hdr.num_pkts;
+    payload_ptrs_.resize(num_pkts);
+    payload_lens_.resize(num_pkts);
+    for (int64_t p = 0; p < num_pkts; p++) {
+      auto payload = static_cast<uint8_t*>(full_batch_data_h_) + p * payload_size_.get();
+      payload_ptrs_[p] = payload;
+      payload_lens_[p] = NextPayloadSize();
+      if (clock_ != BenchClock::NONE) {
+        memcpy(payload + TIMESTAMP_OFFSET, &timestamp, sizeof(timestamp));
+      }
+
+      burst_bytes += payload_lens_[p] + sizeof(UDPIPV4Pkt);
+    }
+
+    // The payload buffer is never changed, so nothing waits for attached payloads to be sent
+    const auto start = std::chrono::steady_clock::now();
+    const AdvNetStatus ret = tmpl_mode_ == BenchTemplate::COPY ?
+        adv_net_fill_udp_burst(msg, tmpl->second, payload_ptrs_.data(), payload_lens_.data()) :
+        adv_net_attach_udp_burst(msg, tmpl->second, payload_ptrs_.data(), payload_lens_.data(),
+                                 nullptr, nullptr);
+    build_ns_ += std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    if (ret != AdvNetStatus::SUCCESS) {
+      HOLOSCAN_LOG_ERROR("Failed to build burst from header template: {}", static_cast<int>(ret));
+      return false;
+    }
+
+    return true;
+  }
+
+  uint16_t NextPayloadSize() {
+    if (min_payload_size_.get() == 0 || min_payload_size_.get() >= payload_size_.get()) {
+      return payload_size_.get();
+    }
+
+    return std::uniform_int_distribution<uint16_t>(min_payload_size_.get(),
+        payload_size_.get())(rng_);
+  }
+
   void *full_batch_data_h_;
   static constexpr uint16_t port_id = 0;
-  static constexpr uint16_t queue_id = 0;
+  uint16_t next_queue_ = 0;
+  std::map<uint16_t, uint32_t> next_seq_;  // Sequence number of the next packet on each queue
+  BenchClock clock_ = BenchClock::NONE;
+  std::minstd_rand rng_;                   // Payload sizes. Default seed, so runs repeat
+  std::chrono::steady_clock::time_point next_train_;  // When the next train may start
+  uint32_t train_pos_ = 0;                 // Bursts of the current train sent so far
+  int64_t cksum_ns_ = 0;                   // Time spent computing checksums in software
+  BenchTemplate tmpl_mode_ = BenchTemplate::NONE;
+  std::map<uint16_t, AdvNetUdpTemplate> templates_;  // Header template of each queue's flow
+  std::vector<void*> payload_ptrs_;
+  std::vector<uint16_t> payload_lens_;
+  int64_t build_ns_ = 0;                   // Time spent building bursts from templates
+  int64_t ttl_bytes_sent_ = 0;
+  int64_t ttl_pkts_sent_ = 0;
+  std::chrono::steady_clock::time_point first_burst_;
+  std::chrono::steady_clock::time_point last_burst_;
   Parameter<uint32_t> batch_size_;
   Parameter<uint16_t> payload_size_;
+  Parameter<uint64_t> num_bursts_;
+  Parameter<uint16_t> num_queues_;
+  Parameter<bool> seq_numbers_;
+  Parameter<std::string> timestamps_;
+  Parameter<uint16_t> min_payload_size_;
+  Parameter<double> rate_gbps_;
+  Parameter<uint32_t> train_bursts_;
+  Parameter<bool> time_checksums_;
+  Parameter<std::string> header_template_;
 };
 
 class AdvNetworkingBenchRxOp : public Operator {
@@ -117,20 +459,64 @@ class AdvNetworkingBenchRxOp : public Operator {
   ~AdvNetworkingBenchRxOp() {
     HOLOSCAN_LOG_INFO("Finished receiver with {}/{} bytes/packets received",
         ttl_bytes_recv_, ttl_pkts_recv_);
+
+    // The first burst is left out of the rate since it includes the time waiting for the sender
+    auto secs = std::chrono::duration<double>(last_burst_ - first_burst_).count();
+    if (secs > 0) {
+      HOLOSCAN_LOG_INFO("Receive rate: {:.0f} bursts/s, {:.0f} packets/s, {:.2f} Gbps",
+          (ttl_bursts_recv_ - 1) / secs, (ttl_pkts_recv_ - first_burst_pkts_) / secs,
+          (ttl_bytes_recv_ - first_burst_bytes_) * 8 / secs / 1e9);
+    }
+
+    if (parse_bursts_ > 0) {
+      HOLOSCAN_LOG_INFO("Burst parsing: {:.0f} ns/burst, {:.1f} ns/packet",
+          static_cast<double>(parse_ns_) / parse_bursts_,
+          static_cast<double>(parse_ns_) / parse_pkts_);
+    }
+
+    if (reorder_ns_ > 0) {
+      HOLOSCAN_LOG_INFO("Payload reassembly ({}): {} bytes at {:.2f} GB/s",
+          reorder_ ? fmt::format("{} threads", reorder_->NumThreads()) : "per-burst gather",
+          reorder_bytes_, static_cast<double>(reorder_bytes_) / reorder_ns_);
+    }
+
+    for (const auto &[q, seq] : seq_trackers_) {
+      HOLOSCAN_LOG_INFO("Queue {} sequence: {} packets, {} gaps, {} lost, {} late, {} duplicate, "
+          "max reorder depth {}", q, seq.pkts, seq.gaps, seq.lost_pkts, seq.late_pkts,
+          seq.dup_pkts, seq.max_reorder);
+    }
+
+    for (const auto &[q, hist] : latency_) {
+      HOLOSCAN_LOG_INFO("Queue {} latency: {} packets, p50 {:.1f} us, p99 {:.1f} us, "
+          "p99.9 {:.1f} us, max {:.1f} us", q, hist.Count(), hist.Percentile(50) / 1e3,
+          hist.Percentile(99) / 1e3, hist.Percentile(99.9) / 1e3, hist.Max() / 1e3);
+    }
   }
 
   void initialize() override {
     HOLOSCAN_LOG_INFO("AdvNetworkingBenchRxOp::initialize()");
     holoscan::Operator::initialize();
 
+    if (!ParseBenchClock(timestamps_.get(), clock_)) {
+      return;
+    }
+
     // For this example assume all packets are the same size, specified in the config
     nom_payload_size_ = max_packet_size_.get() - sizeof(UDPIPV4Pkt);
 
-    cudaMallocHost(&full_batch_data_h_, batch_size_.get() * nom_payload_size_);
-    cudaMalloc(&full_batch_data_d_,     batch_size_.get() * nom_payload_size_);
+    // Without a GPU the batch is staged in regular memory
+    const size_t batch_bytes = batch_size_.get() * nom_payload_size_;
+    if (cudaMallocHost(&full_batch_data_h_, batch_bytes) != cudaSuccess) {
+      HOLOSCAN_LOG_WARN("Failed to allocate host-pinned batch buffer; using pageable memory");
+      full_batch_data_h_ = aligned_alloc(64, (batch_bytes + 63) / 64 * 64);
+    }
 
     if (hds_.get()) {
+      cudaMalloc(&full_batch_data_d_, batch_bytes);
       cudaMallocHost((void**)&h_dev_ptrs_, sizeof(void*) * batch_size_.get());
+    } else if (reorder_threads_.get() > 0) {
+      reorder_ = std::make_unique<CpuPacketReorder>(reorder_threads_.get(), reorder_cpus_.get());
+      reorder_ptrs_.reserve(batch_size_.get());
     }
 
     HOLOSCAN_LOG_INFO("AdvNetworkingBenchRxOp::initialize() complete");
@@ -144,17 +530,53 @@ class AdvNetworkingBenchRxOp : public Operator {
         "Batch size in packets for each processing epoch", 1000);
     spec.param<uint16_t>(max_packet_size_, "max_packet_size",
         "Max packet size", "Maximum packet size expected from sender", 9100);
+    spec.param<uint64_t>(num_packets_, "num_packets", "Number of packets",
+        "Packets to receive before stopping the application. 0 runs until stopped", 0);
+    spec.param<bool>(burst_list_, "burst_list", "Burst list",
+        "Bursts arrive as an AdvNetBurstList rather than one at a time", false);
+    spec.param<bool>(seq_numbers_, "sequence_numbers", "Sequence numbers",
+        "Check the 32-bit sequence number the transmitter puts at the start of each payload",
+        false);
+    spec.param<std::string>(timestamps_, "timestamps", "Timestamps",
+        "Clock the transmitter stamps payloads with, to measure one-way latency: none, realtime "
+        "or monotonic", "none");
+    spec.param<uint32_t>(reorder_threads_, "reorder_threads", "Reorder threads",
+        "Threads reassembling each CPU-only batch with the CPU packet reorder. 0 gathers the "
+        "payloads of each burst as it arrives", 0);
+    spec.param<std::vector<int>>(reorder_cpus_, "reorder_cpus", "Reorder CPU cores",
+        "Cores to pin the extra reorder threads to", std::vector<int>{});
   }
 
   void compute(InputContext& op_input, OutputContext&, ExecutionContext& context) override {
+    if (burst_list_.get()) {
+      auto bursts = op_input.receive<AdvNetBurstList>("burst_in");
+      for (auto &burst : *bursts) {
+        ProcessBurst(burst, context);
+      }
+
+      return;
+    }
+
+    ProcessBurst(op_input.receive<AdvNetBurstParams>("burst_in"), context);
+  }
+
+ private:
+  void ProcessBurst(std::shared_ptr<AdvNetBurstParams> burst, ExecutionContext& context) {
     int64_t ttl_bytes_in_cur_batch_   = 0;
-    auto burst                        = op_input.receive<AdvNetBurstParams>("burst_in");
     ttl_pkts_recv_                    += adv_net_get_num_pkts(burst);
+    CountBurst(burst, context);
 
-    // If packets are coming in from our non-GPUDirect queue, free them and move on
+    // If packets are coming in from our non-GPUDirect queue, free them and move on. Sequence
+    // numbers and latency are still checked, so the loopback covers every queue.
     if (burst->hdr.q_id == 0) {
+      if (seq_numbers_.get() || clock_ != BenchClock::NONE) {
+        const auto start = std::chrono::steady_clock::now();
+        ParseBurst(burst);
+        AddParseTime(start, adv_net_get_num_pkts(burst));
+      }
+
       adv_net_free_cpu_pkts_and_burst(burst);
-      HOLOSCAN_LOG_INFO("Freeing CPU packets on queue 0");
+      HOLOSCAN_LOG_DEBUG("Freeing CPU packets on queue 0");
       return;
     }
 
@@ -172,22 +594,38 @@ class AdvNetworkingBenchRxOp : public Operator {
 
       ttl_bytes_recv_ += ttl_bytes_in_cur_batch_;
     } else {
-      auto batch_offset =  aggr_pkts_recv_ * nom_payload_size_;
-      for (int p = 0; p < adv_net_get_num_pkts(burst); p++) {
-        auto pkt = static_cast<UDPIPV4Pkt*>(adv_net_get_cpu_pkt_ptr(burst, p));
-        auto len = ntohs(pkt->udp.len) - 8;
-
-        // assert(len + sizeof(UDPIPV4Pkt) == max_packet_size_.get());
-
-        memcpy((char*)full_batch_data_h_ + batch_offset + p * nom_payload_size_,
-            pkt->payload, len);
+      const auto start = std::chrono::steady_clock::now();
+      ParseBurst(burst);
+      AddParseTime(start, adv_net_get_num_pkts(burst));
+
+      // The CPU reorder copies the whole batch at once, so only the payload pointers are kept here
+      if (reorder_) {
+        for (int p = 0; p < adv_net_get_num_pkts(burst); p++) {
+          if (pkt_info_[p].valid && pkt_info_[p].payload_len >= nom_payload_size_ &&
+              reorder_ptrs_.size() < batch_size_.get()) {
+            reorder_ptrs_.push_back(static_cast<uint8_t*>(adv_net_get_cpu_pkt_ptr(burst, p)) +
+                                    pkt_info_[p].payload_offset);
+          }
+        }
+      } else {
+        const auto gather_start = std::chrono::steady_clock::now();
+        const auto batch_offset = aggr_pkts_recv_ * nom_payload_size_;
+        reorder_bytes_ += adv_net_gather_udp_payloads(burst, pkt_info_.data(),
+            static_cast<char*>(full_batch_data_h_) + batch_offset,
+            batch_size_.get() * nom_payload_size_ - batch_offset, nom_payload_size_);
+        AddReorderTime(gather_start);
+      }
 
-        ttl_bytes_recv_ += len + sizeof(UDPIPV4Pkt);
-        ttl_bytes_in_cur_batch_ += len + sizeof(UDPIPV4Pkt);
+      for (int p = 0; p < adv_net_get_num_pkts(burst); p++) {
+        ttl_bytes_in_cur_batch_ += pkt_info_[p].valid ?
+            pkt_info_[p].payload_offset + pkt_info_[p].payload_len :
+            adv_net_get_cpu_packet_len(burst, p);
       }
+
+      ttl_bytes_recv_ += ttl_bytes_in_cur_batch_;
     }
 
-    burst_bufs_[burst_buf_idx_++] = burst;
+    burst_bufs_.push_back(burst);
     aggr_pkts_recv_ += adv_net_get_num_pkts(burst);
 
     if (aggr_pkts_recv_ >= batch_size_.get()) {
@@ -203,26 +641,123 @@ class AdvNetworkingBenchRxOp : public Operator {
           exit(1);
         }
 
-        for (int b = 0; b < burst_buf_idx_; b++) {
-          adv_net_free_all_burst_pkts_and_burst(burst_bufs_[b]);
+        for (auto &b : burst_bufs_) {
+          adv_net_free_all_burst_pkts_and_burst(b);
         }
       } else {
-        for (int b = 0; b < burst_buf_idx_; b++) {
-          adv_net_free_cpu_pkts_and_burst(burst_bufs_[b]);
+        if (reorder_) {
+          const auto start = std::chrono::steady_clock::now();
+          reorder_->Reorder(full_batch_data_h_, reorder_ptrs_.data(), nom_payload_size_,
+                            reorder_ptrs_.size());
+          reorder_bytes_ += reorder_ptrs_.size() * nom_payload_size_;
+          AddReorderTime(start);
+          reorder_ptrs_.clear();
+        }
+
+        for (auto &b : burst_bufs_) {
+          adv_net_free_cpu_pkts_and_burst(b);
         }
       }
 
-      burst_buf_idx_ = 0;
+      burst_bufs_.clear();
     }
   }
 
- private:
-  // Holds burst buffers that cannot be freed yet
-  std::array<std::shared_ptr<AdvNetBurstParams>, 256> burst_bufs_;
-  int     burst_buf_idx_ = 0;                // Index into burst_buf_idx_ of current burst
+  // Validates and extracts the headers of every packet into pkt_info_, and checks sequence numbers
+  // and latency
+  void ParseBurst(std::shared_ptr<AdvNetBurstParams> &burst) {
+    const int64_t num_pkts = adv_net_get_num_pkts(burst);
+    if (pkt_info_.size() < static_cast<size_t>(num_pkts)) {
+      pkt_info_.resize(num_pkts);
+    }
+
+    adv_net_parse_udp_burst(burst, pkt_info_.data(), seq_numbers_.get() ? SEQ_OFFSET : -1);
+    if (seq_numbers_.get()) {
+      adv_net_track_seq(seq_trackers_[burst->hdr.q_id], pkt_info_.data(), num_pkts);
+    }
+
+    if (clock_ != BenchClock::NONE) {
+      TrackLatency(burst);
+    }
+  }
+
+  // Latency is measured to when the burst reaches this operator, so it includes the batching
+  void TrackLatency(std::shared_ptr<AdvNetBurstParams> &burst) {
+    const int64_t now = BenchClockNs(clock_);
+    auto &hist = latency_[burst->hdr.q_id];
+    for (int p = 0; p < adv_net_get_num_pkts(burst); p++) {
+      if (!pkt_info_[p].valid ||
+          pkt_info_[p].payload_len < TIMESTAMP_OFFSET + sizeof(int64_t)) {
+        continue;
+      }
+
+      int64_t timestamp;
+      memcpy(&timestamp, static_cast<uint8_t*>(adv_net_get_cpu_pkt_ptr(burst, p)) +
+          pkt_info_[p].payload_offset + TIMESTAMP_OFFSET, sizeof(timestamp));
+      hist.Add(now - static_cast<int64_t>(be64toh(timestamp)));
+    }
+  }
+
+  void AddParseTime(std::chrono::steady_clock::time_point start, int64_t num_pkts) {
+    parse_ns_ += std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    parse_bursts_++;
+    parse_pkts_ += num_pkts;
+  }
+
+  void AddReorderTime(std::chrono::steady_clock::time_point start) {
+    reorder_ns_ += std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start).count();
+  }
+
+  // Queue 0 bursts are freed without their payloads being gathered, so their bytes are counted
+  // from the packet lengths here. Stops the application once num_packets have been received.
+  void CountBurst(std::shared_ptr<AdvNetBurstParams> burst, ExecutionContext& context) {
+    int64_t bytes = 0;
+    if (burst->hdr.q_id == 0) {
+      for (int p = 0; p < adv_net_get_num_pkts(burst); p++) {
+        bytes += adv_net_get_cpu_packet_len(burst, p);
+      }
+
+      ttl_bytes_recv_ += bytes;
+    }
+
+    ttl_bursts_recv_++;
+    last_burst_ = std::chrono::steady_clock::now();
+    if (first_burst_pkts_ == 0) {
+      first_burst_       = last_burst_;
+      first_burst_pkts_  = adv_net_get_num_pkts(burst);
+      first_burst_bytes_ = bytes;
+    }
+
+    if (num_packets_.get() > 0 && ttl_pkts_recv_ >= num_packets_.get()) {
+      HOLOSCAN_LOG_INFO("Received {} packets; stopping", ttl_pkts_recv_);
+      GxfGraphInterrupt(context.context());
+    }
+  }
+
+  // Holds burst buffers that cannot be freed yet. A batch may span any number of bursts when they
+  // are small, so this grows as needed rather than having a fixed limit
+  std::vector<std::shared_ptr<AdvNetBurstParams>> burst_bufs_;
   int64_t ttl_bytes_recv_ = 0;               // Total bytes received in operator
   int64_t ttl_pkts_recv_ = 0;                // Total packets received in operator
   int64_t aggr_pkts_recv_ = 0;               // Aggregate packets received in processing batch
+  int64_t ttl_bursts_recv_ = 0;              // Total bursts received in operator
+  int64_t first_burst_pkts_ = 0;             // Packets in the first burst, left out of the rate
+  int64_t first_burst_bytes_ = 0;            // Bytes in the first burst, left out of the rate
+  int64_t parse_ns_ = 0;                     // Time spent parsing and gathering bursts
+  int64_t parse_bursts_ = 0;                 // Bursts parsed
+  int64_t parse_pkts_ = 0;                   // Packets in the bursts parsed
+  int64_t reorder_ns_ = 0;                   // Time spent copying payloads into batches
+  int64_t reorder_bytes_ = 0;                // Payload bytes copied into batches
+  std::vector<AdvNetUdpPktInfo> pkt_info_;   // Headers of the burst being processed
+  std::unique_ptr<CpuPacketReorder> reorder_;  // CPU-only batch reassembly, if enabled
+  std::vector<const void*> reorder_ptrs_;    // Payloads of the batch waiting for reorder_
+  std::map<uint16_t, AdvNetSeqTracker> seq_trackers_;  // Sequence number state of each queue
+  std::map<uint16_t, LatencyHistogram> latency_;       // One-way latency of each queue
+  BenchClock clock_ = BenchClock::NONE;      // Clock payloads are stamped with
+  std::chrono::steady_clock::time_point first_burst_;
+  std::chrono::steady_clock::time_point last_burst_;
   uint16_t nom_payload_size_;                // Nominal payload size (no headers)
   void **h_dev_ptrs_;                        // Host-pinned list of device pointers
   void *full_batch_data_h_;                  // Host-pinned aggregated batch
@@ -230,6 +765,12 @@ class AdvNetworkingBenchRxOp : public Operator {
   Parameter<bool> hds_;                      // Header-data split enabled
   Parameter<uint32_t> batch_size_;           // Batch size for one processing block
   Parameter<uint16_t> max_packet_size_;      // Maximum size of a single packet
+  Parameter<uint64_t> num_packets_;          // Packets to receive before stopping. 0 is no limit
+  Parameter<bool> burst_list_;               // Bursts arrive several at a time in a list
+  Parameter<bool> seq_numbers_;              // Payloads start with a per-queue sequence number
+  Parameter<std::string> timestamps_;        // Clock payloads are stamped with, or none
+  Parameter<uint32_t> reorder_threads_;      // Threads reassembling CPU-only batches. 0 gathers
+  Parameter<std::vector<int>> reorder_cpus_;  // Cores for the extra reorder threads
 };
 
 }  // namespace holoscan::ops
@@ -243,17 +784,36 @@ class App : public holoscan::Application {
     const auto [rx_en, tx_en] = holoscan::ops::adv_net_get_rx_tx_cfg_en(config());
 
     if (rx_en) {
+      // The RX operator emits lists of bursts when it may dequeue more than one per tick
+      const bool burst_list = holoscan::ops::adv_net_get_rx_bursts_per_tick(config()) > 1;
       auto bench_rx     = make_operator<ops::AdvNetworkingBenchRxOp>("bench_rx",
-                                                                      from_config("bench_rx"));
+                                              from_config("bench_rx"),
+                                              Arg("burst_list", burst_list));
       auto adv_net_rx   = make_operator<ops::AdvNetworkOpRx>("adv_network_rx",
                                               from_config("advanced_network"),
                                               make_condition<BooleanCondition>("is_alive", true));
       add_flow(adv_net_rx, bench_rx, {{"burst_out", "burst_in"}});
     }
     if (tx_en) {
-      auto bench_tx       = make_operator<ops::AdvNetworkingBenchTxOp>("bench_tx",
+      // A fixed number of bursts lets the TX to RX loopback run end to end without intervention
+      uint64_t num_bursts = 0;
+      for (const auto &node : config().yaml_nodes()) {
+        if (node["bench_tx"]["num_bursts"].IsDefined()) {
+          num_bursts = node["bench_tx"]["num_bursts"].as<uint64_t>();
+        }
+      }
+
+      std::shared_ptr<ops::AdvNetworkingBenchTxOp> bench_tx;
+      if (num_bursts > 0) {
+        bench_tx          = make_operator<ops::AdvNetworkingBenchTxOp>("bench_tx",
+                                              from_config("bench_tx"),
+                                              make_condition<CountCondition>(num_bursts));
+      } else {
+        bench_tx          = make_operator<ops::AdvNetworkingBenchTxOp>("bench_tx",
                                               from_config("bench_tx"),
                                               make_condition<BooleanCondition>("is_alive", true));
+      }
+
       auto adv_net_tx     = make_operator<ops::AdvNetworkOpTx>("adv_network_tx",
                                                               from_config("advanced_network"));
       add_flow(bench_tx, adv_net_tx, {{"burst_out", "burst_in"}});
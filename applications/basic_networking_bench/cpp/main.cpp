@@ -0,0 +1,354 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <time.h>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include "basic_network_operator_latency_stats.h"
+#include "basic_network_operator_rx.h"
+#include "basic_network_operator_tx.h"
+#include "holoscan/holoscan.hpp"
+
+namespace holoscan::ops {
+
+// Gaps bucketed with 1/16 relative precision, so percentiles need no per-packet storage
+class GapHistogram {
+ public:
+  void Add(uint64_t ns) {
+    buckets_[Bucket(ns)]++;
+    count_++;
+    max_ = std::max(max_, ns);
+  }
+
+  // Upper bound of the bucket holding the pct percentile
+  uint64_t Percentile(double pct) const {
+    const uint64_t rank = std::max<uint64_t>(1, std::ceil(pct / 100 * count_));
+    uint64_t seen = 0;
+    for (size_t b = 0; b < buckets_.size(); b++) {
+      seen += buckets_[b];
+      if (seen >= rank) {
+        return std::min(max_, BucketMax(b));
+      }
+    }
+
+    return max_;
+  }
+
+ private:
+  static constexpr int SUB_BITS = 4;
+  static constexpr uint64_t SUB_BUCKETS = 1 << SUB_BITS;
+
+  static size_t Bucket(uint64_t v) {
+    if (v < SUB_BUCKETS) {
+      return v;
+    }
+
+    const int exp = 63 - __builtin_clzll(v);
+    return (exp - SUB_BITS + 1) * SUB_BUCKETS + ((v >> (exp - SUB_BITS)) & (SUB_BUCKETS - 1));
+  }
+
+  static uint64_t BucketMax(size_t b) {
+    if (b < SUB_BUCKETS) {
+      return b;
+    }
+
+    const int shift = b / SUB_BUCKETS - 1;
+    return ((SUB_BUCKETS + b % SUB_BUCKETS + 1) << shift) - 1;
+  }
+
+  std::array<uint64_t, 64 * SUB_BUCKETS> buckets_{};
+  uint64_t count_ = 0;
+  uint64_t max_ = 0;
+};
+
+class BasicNetworkingBenchTxOp : public Operator {
+ public:
+  HOLOSCAN_OPERATOR_FORWARD_ARGS(BasicNetworkingBenchTxOp)
+
+  BasicNetworkingBenchTxOp() = default;
+
+  ~BasicNetworkingBenchTxOp() {
+    auto secs = std::chrono::duration<double>(last_send_ - first_send_).count();
+    if (bursts_sent_ < 2 || secs <= 0.0) {
+      return;
+    }
+
+    // Rate over the bursts after the first, since the first only starts the clock
+    auto pkts = (bursts_sent_ - 1) * batch_size_.get();
+    HOLOSCAN_LOG_INFO("TX rate: {:.0f} packets/s, {:.3f} Gbps, waited for a free buffer {} times",
+        pkts / secs, pkts * payload_size_.get() * 8 / secs / 1e9, pool_waits_);
+  }
+
+  void setup(OperatorSpec& spec) override {
+    spec.output<NetworkOpBurstParams>("burst_out");
+
+    spec.param<uint32_t>(batch_size_, "batch_size", "Batch size",
+      "Number of packets sent in each burst", 64);
+    spec.param<uint16_t>(payload_size_, "payload_size", "Payload size",
+      "UDP payload size of each packet. Must match the TX operator max_payload_size", 1400);
+    spec.param<int64_t>(num_bursts_, "num_bursts", "Number of bursts",
+      "Number of bursts to send before stopping", 100000);
+    spec.param<uint32_t>(num_flows_, "num_flows", "Number of flows",
+      "Number of transmitters, each sending num_bursts from its own socket", 1);
+    spec.param<uint32_t>(pool_size_, "pool_size", "Pool size",
+      "Number of burst buffers. Must cover every burst the TX operator may hold at once", 4);
+  }
+
+  void initialize() override {
+    holoscan::Operator::initialize();
+    pool_ = NetworkBufferPool::Create(pool_size_.get(), batch_size_.get() * payload_size_.get());
+  }
+
+  void compute(InputContext&, OutputContext& op_output, ExecutionContext&) override {
+    auto len = batch_size_.get() * payload_size_.get();
+    auto buf = pool_->Get();
+    if (!buf) {
+      // The pool is sized so this only happens when the TX operator runs on another thread, so wait
+      // for it to release a burst rather than dropping one the CountCondition has already counted
+      pool_waits_++;
+      while (!(buf = pool_->Get())) { std::this_thread::sleep_for(std::chrono::microseconds(10)); }
+    }
+
+    // Stamp each packet with a sequence number so captures are easy to inspect
+    for (uint32_t p = 0; p < batch_size_.get(); p++) {
+      auto seq = htonl(seq_++);
+      memcpy(buf.data() + p * payload_size_.get(), &seq, std::min(sizeof(seq),
+            static_cast<size_t>(payload_size_.get())));
+    }
+
+    auto msg = std::make_shared<NetworkOpBurstParams>(std::move(buf), len, batch_size_.get());
+    op_output.emit(msg, "burst_out");
+
+    // With the socket backend bursts are sent by the time the next one is generated, so this tracks
+    // the TX operator. With io_uring up to io_uring_depth sends may still be in flight
+    last_send_ = std::chrono::steady_clock::now();
+    if (bursts_sent_++ == 0) { first_send_ = last_send_; }
+  };
+
+ private:
+  std::shared_ptr<NetworkBufferPool> pool_;
+  uint32_t seq_ = 0;
+  uint64_t bursts_sent_ = 0;
+  uint64_t pool_waits_ = 0;
+  std::chrono::steady_clock::time_point first_send_;
+  std::chrono::steady_clock::time_point last_send_;
+  Parameter<uint32_t> batch_size_;
+  Parameter<uint16_t> payload_size_;
+  Parameter<int64_t> num_bursts_;
+  Parameter<uint32_t> num_flows_;
+  Parameter<uint32_t> pool_size_;
+};
+
+class BasicNetworkingBenchRxOp : public Operator {
+ public:
+  HOLOSCAN_OPERATOR_FORWARD_ARGS(BasicNetworkingBenchRxOp)
+
+  BasicNetworkingBenchRxOp() = default;
+
+  ~BasicNetworkingBenchRxOp() {
+    HOLOSCAN_LOG_INFO("Finished receiver with {}/{} bytes/packets received",
+        ttl_bytes_recv_, ttl_pkts_recv_);
+
+    // The first burst only starts the clock, so it is not included in the rates
+    auto pkts  = ttl_pkts_recv_ - first_burst_pkts_;
+    auto bytes = ttl_bytes_recv_ - first_burst_bytes_;
+    auto secs  = std::chrono::duration<double>(last_recv_ - first_recv_).count();
+    if (pkts == 0 || secs <= 0.0) {
+      return;
+    }
+
+    HOLOSCAN_LOG_INFO("RX rate: {:.0f} packets/s, {:.3f} Gbps, {:.1f} ns CPU/packet",
+        pkts / secs, bytes * 8 / secs / 1e9,
+        static_cast<double>(last_cpu_ns_ - first_cpu_ns_) / pkts);
+
+    if (num_gaps_ > 1 && pkt_gaps_) {
+      HOLOSCAN_LOG_INFO("Packet spacing from receive timestamps: min {:.0f} ns, mean {:.0f} ns, "
+          "p99 {} ns, max {:.0f} ns, stddev {:.0f} ns over {} gaps", gap_min_ns_, gap_mean_ns_,
+          gap_hist_.Percentile(99), gap_max_ns_, std::sqrt(gap_m2_ / (num_gaps_ - 1)), num_gaps_);
+    } else if (num_gaps_ > 1) {
+      HOLOSCAN_LOG_INFO("Average packet spacing between bursts: mean {:.0f} ns, stddev {:.0f} ns, "
+          "min {:.0f} ns, max {:.0f} ns over {} bursts. Set rx_timestamps for per-packet spacing",
+          gap_mean_ns_, std::sqrt(gap_m2_ / (num_gaps_ - 1)), gap_min_ns_, gap_max_ns_, num_gaps_);
+    }
+  }
+
+  void setup(OperatorSpec& spec) override {
+    spec.input<NetworkOpBurstParams>("burst_in");
+
+    spec.param<uint64_t>(num_packets_, "num_packets", "Number of packets",
+      "Stop after this many packets are received", 10000000);
+  }
+
+  void compute(InputContext& op_input, OutputContext&, ExecutionContext& context) override {
+    auto burst = op_input.receive<NetworkOpBurstParams>("burst_in");
+    auto now   = std::chrono::steady_clock::now();
+    auto cpu   = CpuTimeNs();
+
+    if (burst->pkt_ts != nullptr) {
+      // Per-packet receive timestamps give the spacing each packet actually arrived with, which
+      // is what pacing controls. The first gap of a burst is from the last packet of the previous.
+      pkt_gaps_ = true;
+      for (uint32_t p = 0; p < burst->num_pkts; p++) {
+        if (last_pkt_ts_ != 0 && burst->pkt_ts[p] >= last_pkt_ts_) {
+          AddGap(static_cast<double>(burst->pkt_ts[p] - last_pkt_ts_));
+          gap_hist_.Add(burst->pkt_ts[p] - last_pkt_ts_);
+        }
+
+        last_pkt_ts_ = burst->pkt_ts[p];
+      }
+    }
+
+    if (ttl_pkts_recv_ == 0) {
+      first_recv_         = now;
+      first_cpu_ns_       = cpu;
+      first_burst_pkts_   = burst->num_pkts;
+      first_burst_bytes_  = burst->len;
+    } else if (!pkt_gaps_) {
+      // Without timestamps only the average gap over each burst is known
+      AddGap(std::chrono::duration<double, std::nano>(now - last_recv_).count() / burst->num_pkts);
+    }
+
+    last_recv_        = now;
+    last_cpu_ns_      = cpu;
+    ttl_pkts_recv_   += burst->num_pkts;
+    ttl_bytes_recv_  += burst->len;
+
+    if (ttl_pkts_recv_ >= num_packets_.get()) { GxfGraphInterrupt(context.context()); }
+  }
+
+ private:
+  // Running statistics of the gap between packets, or of the average gap over each burst when the
+  // bursts have no receive timestamps
+  void AddGap(double gap_ns) {
+    num_gaps_++;
+    auto delta   = gap_ns - gap_mean_ns_;
+    gap_mean_ns_ += delta / num_gaps_;
+    gap_m2_      += delta * (gap_ns - gap_mean_ns_);
+    gap_min_ns_   = std::min(gap_min_ns_, gap_ns);
+    gap_max_ns_   = std::max(gap_max_ns_, gap_ns);
+  }
+
+  static uint64_t CpuTimeNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + ts.tv_nsec;
+  }
+
+  uint64_t ttl_pkts_recv_ = 0;                          // Total packets received
+  uint64_t ttl_bytes_recv_ = 0;                         // Total bytes received
+  uint64_t first_burst_pkts_ = 0;                       // Packets in the burst that started timing
+  uint64_t first_burst_bytes_ = 0;                      // Bytes in the burst that started timing
+  uint64_t first_cpu_ns_ = 0;                           // Process CPU time at first burst
+  uint64_t last_cpu_ns_ = 0;                            // Process CPU time at last burst
+  std::chrono::steady_clock::time_point first_recv_;    // Wall time of first burst
+  std::chrono::steady_clock::time_point last_recv_;     // Wall time of last burst
+  uint64_t num_gaps_ = 0;
+  double gap_mean_ns_ = 0.0;
+  double gap_m2_ = 0.0;
+  double gap_min_ns_ = std::numeric_limits<double>::max();
+  double gap_max_ns_ = 0.0;
+  GapHistogram gap_hist_;                               // Per-packet gaps, for percentiles
+  bool pkt_gaps_ = false;                               // Gaps come from receive timestamps
+  uint64_t last_pkt_ts_ = 0;                            // Receive time of the last packet
+  Parameter<uint64_t> num_packets_;
+};
+
+}  // namespace holoscan::ops
+
+class App : public holoscan::Application {
+ public:
+  void compose() override {
+    using namespace holoscan;
+
+    bool rx_en = false;
+    bool tx_en = false;
+    bool latency_en = false;
+    for (const auto &node : config().yaml_nodes()) {
+      rx_en |= node["network_rx"].IsMap();
+      tx_en |= node["network_tx"].IsMap();
+      latency_en |= node["latency_stats"].IsMap();
+    }
+
+    if (rx_en) {
+      auto net_rx   = make_operator<ops::BasicNetworkOpRx>("network_rx",
+                        from_config("network_rx"),
+                        make_condition<BooleanCondition>("is_alive"));
+      auto bench_rx = make_operator<ops::BasicNetworkingBenchRxOp>("bench_rx",
+                                                                  from_config("bench_rx"));
+      add_flow(net_rx, bench_rx, {{"burst_out", "burst_in"}});
+
+      if (latency_en) {
+        auto latency = make_operator<ops::BasicNetworkOpLatencyStats>("latency_stats",
+                                                                     from_config("latency_stats"));
+        add_flow(net_rx, latency, {{"burst_out", "burst_in"}});
+      }
+    }
+
+    if (tx_en) {
+      // Each flow has its own TX socket and therefore its own source port, which lets a sharded
+      // receiver spread the flows across its SO_REUSEPORT sockets
+      auto num_flows = from_config("bench_tx.num_flows").as<uint32_t>();
+
+      // A burst stays in use until the TX operator has sent it. The socket backend sends it within
+      // compute, so a few buffers cover the one being built, the one queued and the one being sent.
+      // The io_uring backend holds up to one burst per send in flight.
+      uint32_t pool_size = 4;
+      if (from_config("network_tx.io_backend").as<std::string>() == "io_uring") {
+        pool_size = from_config("network_tx.io_uring_depth").as<uint32_t>() + 4;
+      }
+
+      for (uint32_t f = 0; f < num_flows; f++) {
+        auto bench_tx = make_operator<ops::BasicNetworkingBenchTxOp>(
+                          "bench_tx_" + std::to_string(f),
+                          from_config("bench_tx"),
+                          Arg("pool_size", pool_size),
+                          make_condition<CountCondition>(
+                              from_config("bench_tx.num_bursts").as<int64_t>()));
+        auto net_tx   = make_operator<ops::BasicNetworkOpTx>("network_tx_" + std::to_string(f),
+                                                             from_config("network_tx"));
+        add_flow(bench_tx, net_tx, {{"burst_out", "burst_in"}});
+      }
+    }
+  }
+};
+
+int main(int argc, char** argv) {
+  holoscan::load_env_log_level();
+
+  auto app = holoscan::make_application<App>();
+
+  // Get the configuration
+  if (argc < 2) {
+    HOLOSCAN_LOG_ERROR("Usage: {} config_file", argv[0]);
+    return -1;
+  }
+
+  auto config_path = std::filesystem::canonical(argv[0]).parent_path();
+  config_path += "/" + std::string(argv[1]);
+  app->config(config_path);
+
+  app->run();
+
+  return 0;
+}
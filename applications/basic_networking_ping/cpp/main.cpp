@@ -32,11 +32,16 @@ class BasicNetworkPingTxOp : public Operator {
   void setup(OperatorSpec& spec) override { spec.output<NetworkOpBurstParams>("burst_out"); }
 
   void compute(InputContext&, OutputContext& op_output, ExecutionContext&) override {
-    auto mem = new uint8_t[sizeof(index_)];
-    auto intp = reinterpret_cast<int*>(mem);
+    auto buf = pool_->Get();
+    if (!buf) {
+      HOLOSCAN_LOG_ERROR("No free ping buffers; skipping message {}", index_);
+      return;
+    }
+
+    auto intp = reinterpret_cast<int*>(buf.data());
     *intp = index_;
 
-    auto value = std::make_shared<NetworkOpBurstParams>(mem, sizeof(*intp), 1);
+    auto value = std::make_shared<NetworkOpBurstParams>(std::move(buf), sizeof(*intp), 1);
     HOLOSCAN_LOG_INFO("Ping message sent with value {}", index_);
     op_output.emit(value, "burst_out");
 
@@ -44,6 +49,7 @@ class BasicNetworkPingTxOp : public Operator {
   };
 
   int index_ = 0;
+  std::shared_ptr<NetworkBufferPool> pool_ = NetworkBufferPool::Create(NUM_MSGS, sizeof(index_));
 };
 
 class BasicNetworkPingRxOp : public Operator {
@@ -59,8 +65,6 @@ class BasicNetworkPingRxOp : public Operator {
     auto val = *reinterpret_cast<int*>(in->data);
     HOLOSCAN_LOG_INFO("Ping message received with value {}", val);
 
-    delete[] in->data;
-
     if (val == NUM_MSGS - 1) { GxfGraphInterrupt(context.context()); }
   }
 
@@ -116,9 +116,15 @@ class PulsePrinterOp : public holoscan::Operator {
       std::cout << "Average amplitude " << data->average_amplitude << std::endl;
     }
 
-    auto buff = new uint32_t[7];
     // Next, place these values into a network burst operator and send it
     if (to_tx.get()) {
+      auto buf = pool_->Get();
+      if (!buf) {
+        HOLOSCAN_LOG_ERROR("No free TX buffers; dropping pulse description");
+        return;
+      }
+
+      auto buff = reinterpret_cast<uint32_t*>(buf.data());
       buff[0] = htonl((uint32_t)data->id);
       buff[1] = htonl((uint32_t)data->low_bin);
       buff[2] = htonl((uint32_t)data->high_bin);
@@ -127,7 +133,7 @@ class PulsePrinterOp : public holoscan::Operator {
       buff[5] = htonl((uint32_t)data->max_amplitude);
       buff[6] = htonl((uint32_t)data->average_amplitude);
       auto out = std::make_shared<NetworkOpBurstParams>(
-          (uint8_t*)buff, sizeof(uint32_t) * burst_length, 1);
+          std::move(buf), sizeof(uint32_t) * burst_length, 1);
       HOLOSCAN_LOG_INFO("Forwarding message to Network TX");
       op_output.emit(out, "burst_out");
     }
@@ -135,6 +141,10 @@ class PulsePrinterOp : public holoscan::Operator {
   holoscan::Parameter<float> sample_rate;
   holoscan::Parameter<bool> to_screen;
   holoscan::Parameter<bool> to_tx;
+
+ private:
+  std::shared_ptr<holoscan::ops::NetworkBufferPool> pool_ =
+      holoscan::ops::NetworkBufferPool::Create(8, sizeof(uint32_t) * burst_length);
 };
 
 // Calculates pulse descriptions.
@@ -16,10 +16,18 @@
  */
 
 #include "adv_network_common.h"
+#include "adv_network_dpdk_mgr.h"
 #include "holoscan/holoscan.hpp"
 #include <rte_mbuf.h>
 #include <rte_memcpy.h>
 #include <rte_ethdev.h>
+#include <rte_prefetch.h>
+#include <arpa/inet.h>
+#include <algorithm>
+#include <vector>
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
 
 namespace holoscan::ops {
 
@@ -103,18 +111,126 @@ void adv_net_free_cpu_pkts_and_burst(std::shared_ptr<AdvNetBurstParams> &burst)
 }
 
 
-bool adv_net_tx_burst_available(int num_pkts) {
-  auto burst_pool = rte_mempool_lookup("TX_BURST_POOL");
-  auto pkt_pool   = rte_mempool_lookup("TX_POOL");
-  if (burst_pool == nullptr || pkt_pool == nullptr) {
+std::vector<AdvNetRxQueueStats> adv_net_get_rx_queue_stats() {
+  return dpdk_mgr.GetRxQueueStats();
+}
+
+AdvNetTelemetry adv_net_get_telemetry() {
+  return dpdk_mgr.GetTelemetry();
+}
+
+static std::string TelemetryLabels(const AdvNetPortStats &p) {
+  return fmt::format("port=\"{}\"", p.port_id);
+}
+
+template <typename T>
+static std::string TelemetryLabels(const T &q) {
+  return fmt::format("port=\"{}\",queue=\"{}\"", q.port_id, q.q_id);
+}
+
+// Append a metric family with one sample per port or queue
+template <typename T, typename F>
+static void AppendMetric(std::string &out, const char *name, const char *type, const char *help,
+    const std::vector<T> &entries, F value) {
+  out += fmt::format("# HELP {} {}\n# TYPE {} {}\n", name, help, name, type);
+  for (const auto &e : entries) {
+    out += fmt::format("{}{{{}}} {}\n", name, TelemetryLabels(e), value(e));
+  }
+}
+
+std::string adv_net_telemetry_to_prometheus(const AdvNetTelemetry &telemetry) {
+  using Port = AdvNetPortStats;
+  using RxQ = AdvNetRxQueueStats;
+  using TxQ = AdvNetTxQueueStats;
+  const auto &ports = telemetry.ports;
+  const auto &rxq = telemetry.rx_queues;
+  const auto &txq = telemetry.tx_queues;
+  std::string out;
+
+  AppendMetric(out, "adv_net_port_rx_packets_total", "counter", "Packets received by the NIC",
+      ports, [](const Port &p) { return p.rx_pkts; });
+  AppendMetric(out, "adv_net_port_tx_packets_total", "counter", "Packets sent by the NIC",
+      ports, [](const Port &p) { return p.tx_pkts; });
+  AppendMetric(out, "adv_net_port_rx_bytes_total", "counter", "Bytes received by the NIC",
+      ports, [](const Port &p) { return p.rx_bytes; });
+  AppendMetric(out, "adv_net_port_tx_bytes_total", "counter", "Bytes sent by the NIC",
+      ports, [](const Port &p) { return p.tx_bytes; });
+  AppendMetric(out, "adv_net_port_rx_missed_total", "counter",
+      "Packets dropped by the NIC because an RX queue was full",
+      ports, [](const Port &p) { return p.rx_missed; });
+  AppendMetric(out, "adv_net_port_rx_errors_total", "counter", "Erroneous packets received",
+      ports, [](const Port &p) { return p.rx_errors; });
+  AppendMetric(out, "adv_net_port_tx_errors_total", "counter", "Packets that failed to send",
+      ports, [](const Port &p) { return p.tx_errors; });
+  AppendMetric(out, "adv_net_port_rx_nombuf_total", "counter",
+      "Packets dropped because no mbuf was free", ports, [](const Port &p) { return p.rx_nombuf; });
+
+  AppendMetric(out, "adv_net_rx_packets_total", "counter",
+      "Packets passed to the RX operator", rxq, [](const RxQ &q) { return q.pkts; });
+  AppendMetric(out, "adv_net_rx_bytes_total", "counter",
+      "Bytes passed to the RX operator", rxq, [](const RxQ &q) { return q.bytes; });
+  AppendMetric(out, "adv_net_rx_bursts_total", "counter",
+      "Bursts passed to the RX operator", rxq, [](const RxQ &q) { return q.bursts; });
+  AppendMetric(out, "adv_net_rx_timeout_bursts_total", "counter",
+      "Bursts passed on partly full because timeout_us passed",
+      rxq, [](const RxQ &q) { return q.timeout_bursts; });
+  AppendMetric(out, "adv_net_rx_dropped_packets_total", "counter",
+      "Packets dropped because no burst buffer was free",
+      rxq, [](const RxQ &q) { return q.dropped_pkts; });
+  AppendMetric(out, "adv_net_rx_recycled_bursts_total", "counter",
+      "Queued bursts dropped under drop_oldest",
+      rxq, [](const RxQ &q) { return q.recycled_bursts; });
+  AppendMetric(out, "adv_net_rx_stalls_total", "counter",
+      "Times the worker waited for a burst buffer", rxq, [](const RxQ &q) { return q.stalls; });
+  AppendMetric(out, "adv_net_rx_stall_seconds_total", "counter",
+      "Time spent waiting for a burst buffer", rxq, [](const RxQ &q) { return q.stall_ns / 1e9; });
+  AppendMetric(out, "adv_net_rx_ring_bursts", "gauge",
+      "Bursts waiting for the RX operator", rxq, [](const RxQ &q) { return q.ring_bursts; });
+  AppendMetric(out, "adv_net_rx_free_bursts", "gauge",
+      "Burst buffers free for the RX worker", rxq, [](const RxQ &q) { return q.free_bursts; });
+
+  const char *hist = "adv_net_rx_burst_fill_latency_us";
+  out += fmt::format("# HELP {} Time from the first packet of a burst arriving to the burst being "
+      "passed on\n# TYPE {} histogram\n", hist, hist);
+  for (const auto &q : rxq) {
+    const auto labels = TelemetryLabels(q);
+    uint64_t count = 0;
+    for (uint32_t b = 0; b < ADV_NET_LATENCY_BUCKETS; b++) {
+      count += q.fill_latency_hist[b];
+      const auto le = b < ADV_NET_LATENCY_BUCKETS - 1 ? std::to_string(1ULL << b) : "+Inf";
+      out += fmt::format("{}_bucket{{{},le=\"{}\"}} {}\n", hist, labels, le, count);
+    }
+    out += fmt::format("{}_sum{{{}}} {}\n", hist, labels, q.fill_latency_ns / 1e3);
+    out += fmt::format("{}_count{{{}}} {}\n", hist, labels, count);
+  }
+
+  AppendMetric(out, "adv_net_tx_packets_total", "counter",
+      "Packets handed to the NIC", txq, [](const TxQ &q) { return q.pkts; });
+  AppendMetric(out, "adv_net_tx_bytes_total", "counter",
+      "Bytes handed to the NIC", txq, [](const TxQ &q) { return q.bytes; });
+  AppendMetric(out, "adv_net_tx_bursts_total", "counter",
+      "Bursts taken from the TX operator", txq, [](const TxQ &q) { return q.bursts; });
+  AppendMetric(out, "adv_net_tx_ring_bursts", "gauge",
+      "Bursts waiting for the TX worker", txq, [](const TxQ &q) { return q.ring_bursts; });
+  AppendMetric(out, "adv_net_tx_free_bursts", "gauge",
+      "Burst buffers free for the TX operator", txq, [](const TxQ &q) { return q.free_bursts; });
+  AppendMetric(out, "adv_net_tx_free_packets", "gauge",
+      "Packet buffers free for the TX operator", txq, [](const TxQ &q) { return q.free_pkts; });
+
+  return out;
+}
+
+bool adv_net_tx_burst_available(int num_pkts, uint16_t port, uint16_t q) {
+  auto txq = dpdk_mgr.GetTxQueue(port, q);
+  if (txq == nullptr) {
     return false;
   }
 
-  if (rte_mempool_empty(burst_pool)) {
+  if (rte_mempool_empty(txq->burst_pool) || rte_mempool_empty(txq->meta_pool)) {
     return false;
   }
 
-  if (rte_mempool_avail_count(pkt_pool) < num_pkts) {
+  if (rte_mempool_avail_count(txq->pkt_pool) < num_pkts) {
     return false;
   }
 
@@ -123,19 +239,19 @@ bool adv_net_tx_burst_available(int num_pkts) {
 
 
 AdvNetStatus adv_net_get_tx_pkt_burst(AdvNetBurstParams *burst) {
-  auto burst_pool = rte_mempool_lookup("TX_BURST_POOL");
-  auto pkt_pool   = rte_mempool_lookup("TX_POOL");
-  if (burst_pool == nullptr || pkt_pool == nullptr) {
+  // Packets come from the pools of the queue set in the burst header
+  auto txq = dpdk_mgr.GetTxQueue(burst->hdr.port_id, burst->hdr.q_id);
+  if (txq == nullptr) {
     return AdvNetStatus::NULL_PTR;
   }
 
-  if (rte_mempool_get(burst_pool, reinterpret_cast<void**>(&burst->cpu_pkts)) != 0) {
+  if (rte_mempool_get(txq->burst_pool, reinterpret_cast<void**>(&burst->cpu_pkts)) != 0) {
     return AdvNetStatus::NO_FREE_BURST_BUFFERS;
   }
 
-  if (rte_pktmbuf_alloc_bulk(pkt_pool, reinterpret_cast<rte_mbuf**>(burst->cpu_pkts),
+  if (rte_pktmbuf_alloc_bulk(txq->pkt_pool, reinterpret_cast<rte_mbuf**>(burst->cpu_pkts),
               static_cast<int>(burst->hdr.num_pkts)) != 0) {
-    rte_mempool_put(burst_pool, reinterpret_cast<void*>(burst->cpu_pkts));
+    rte_mempool_put(txq->burst_pool, reinterpret_cast<void*>(burst->cpu_pkts));
     return AdvNetStatus::NO_FREE_CPU_PACKET_BUFFERS;
   }
 
@@ -192,6 +308,7 @@ void adv_net_set_hdr(AdvNetBurstParams *burst, uint16_t port, uint16_t q, int64_
   burst->hdr.num_pkts = num;
   burst->hdr.port_id = port;
   burst->hdr.q_id = q;
+  burst->hdr.hdrs_complete = false;
 }
 
 void adv_net_set_hdr(std::shared_ptr<AdvNetBurstParams> &burst,
@@ -201,8 +318,7 @@ void adv_net_set_hdr(std::shared_ptr<AdvNetBurstParams> &burst,
 
 
 void adv_net_free_tx_burst(AdvNetBurstParams *burst) {
-  auto burst_pool = rte_mempool_lookup("TX_BURST_POOL");
-  rte_mempool_put(burst_pool, (void *)burst->cpu_pkts);
+  rte_mempool_put(rte_mempool_from_obj(burst->cpu_pkts), (void *)burst->cpu_pkts);
 }
 
 void adv_net_free_tx_burst(std::shared_ptr<AdvNetBurstParams> &burst) {
@@ -210,10 +326,10 @@ void adv_net_free_tx_burst(std::shared_ptr<AdvNetBurstParams> &burst) {
 }
 
 void adv_net_free_rx_burst(AdvNetBurstParams *burst) {
-  auto burst_pool = rte_mempool_lookup("RX_BURST_POOL");
-  rte_mempool_put(burst_pool, (void *)burst->cpu_pkts);
+  // Every RX queue has its own burst pool, which is found from the buffer itself
+  rte_mempool_put(rte_mempool_from_obj(burst->cpu_pkts), (void *)burst->cpu_pkts);
   if (burst->gpu_pkts != nullptr) {
-    rte_mempool_put(burst_pool, (void *)burst->gpu_pkts);
+    rte_mempool_put(rte_mempool_from_obj(burst->gpu_pkts), (void *)burst->gpu_pkts);
   }
 }
 
@@ -237,6 +353,559 @@ void *adv_net_get_gpu_pkt_ptr(std::shared_ptr<AdvNetBurstParams> &burst, int idx
   return rte_pktmbuf_mtod(reinterpret_cast<rte_mbuf*>(burst->gpu_pkts[idx]), void*);
 }
 
+// Packets ahead of the current one that the burst helpers prefetch
+static constexpr int64_t PREFETCH_PKTS = 4;
+
+static inline bool ParseUdpPkt(const rte_mbuf *m, AdvNetUdpPktInfo &info,
+                               int seq_offset, int seq_size) {
+  const auto *pkt = rte_pktmbuf_mtod(m, const uint8_t*);
+  const uint32_t data_len = rte_pktmbuf_data_len(m);
+  uint32_t off = sizeof(rte_ether_hdr);
+  if (data_len < off) {
+    return false;
+  }
+
+  uint16_t ether_type = reinterpret_cast<const rte_ether_hdr*>(pkt)->ether_type;
+  if (ether_type == rte_cpu_to_be_16(RTE_ETHER_TYPE_VLAN)) {
+    if (data_len < off + sizeof(rte_vlan_hdr)) {
+      return false;
+    }
+
+    ether_type = reinterpret_cast<const rte_vlan_hdr*>(pkt + off)->eth_proto;
+    off += sizeof(rte_vlan_hdr);
+  }
+
+  if (ether_type != rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV4) ||
+      data_len < off + sizeof(rte_ipv4_hdr)) {
+    return false;
+  }
+
+  // Fragments are not complete datagrams, so their UDP length cannot be checked
+  const auto *ip = reinterpret_cast<const rte_ipv4_hdr*>(pkt + off);
+  const uint32_t ihl = ip->ihl * 4;
+  const uint32_t ip_len = rte_be_to_cpu_16(ip->total_length);
+  const uint16_t frag = rte_be_to_cpu_16(ip->fragment_offset);
+  if (ip->version != 4 || ip->next_proto_id != IPPROTO_UDP || ihl < sizeof(rte_ipv4_hdr) ||
+      (frag & (RTE_IPV4_HDR_MF_FLAG | RTE_IPV4_HDR_OFFSET_MASK)) != 0 ||
+      ip_len < ihl + sizeof(rte_udp_hdr) || off + ip_len > rte_pktmbuf_pkt_len(m)) {
+    return false;
+  }
+
+  off += ihl;
+  if (data_len < off + sizeof(rte_udp_hdr)) {
+    return false;
+  }
+
+  const auto *udp = reinterpret_cast<const rte_udp_hdr*>(pkt + off);
+  const uint32_t udp_len = rte_be_to_cpu_16(udp->dgram_len);
+  if (udp_len < sizeof(rte_udp_hdr) || udp_len > ip_len - ihl) {
+    return false;
+  }
+
+  info.src_addr = rte_be_to_cpu_32(ip->src_addr);
+  info.dst_addr = rte_be_to_cpu_32(ip->dst_addr);
+  info.src_port = rte_be_to_cpu_16(udp->src_port);
+  info.dst_port = rte_be_to_cpu_16(udp->dst_port);
+  info.payload_offset = off + sizeof(rte_udp_hdr);
+  info.payload_len = udp_len - sizeof(rte_udp_hdr);
+  info.seq = 0;
+  if (seq_offset >= 0) {
+    if (static_cast<uint32_t>(seq_offset + seq_size) > info.payload_len ||
+        info.payload_offset + seq_offset + seq_size > data_len) {
+      return false;
+    }
+
+    const uint8_t *seq = pkt + info.payload_offset + seq_offset;
+    if (seq_size == 2) {
+      uint16_t v;
+      memcpy(&v, seq, sizeof(v));
+      info.seq = rte_be_to_cpu_16(v);
+    } else if (seq_size == 4) {
+      uint32_t v;
+      memcpy(&v, seq, sizeof(v));
+      info.seq = rte_be_to_cpu_32(v);
+    } else {
+      uint64_t v;
+      memcpy(&v, seq, sizeof(v));
+      info.seq = rte_be_to_cpu_64(v);
+    }
+  }
+
+  return true;
+}
+
+int64_t adv_net_parse_udp_burst(AdvNetBurstParams *burst, AdvNetUdpPktInfo *info,
+                                int seq_offset, int seq_size) {
+  const int64_t num_pkts = burst->hdr.num_pkts;
+  auto **pkts = reinterpret_cast<rte_mbuf**>(burst->cpu_pkts);
+  if (seq_offset >= 0 && seq_size != 2 && seq_size != 4 && seq_size != 8) {
+    HOLOSCAN_LOG_CRITICAL("Invalid sequence number size {}", seq_size);
+    for (int64_t p = 0; p < num_pkts; p++) {
+      info[p].valid = false;
+    }
+
+    return 0;
+  }
+
+  // Reading the data pointer touches the mbuf, so mbufs are prefetched twice as far ahead
+  for (int64_t p = 0; p < std::min(num_pkts, 2 * PREFETCH_PKTS); p++) {
+    rte_prefetch0(pkts[p]);
+  }
+
+  for (int64_t p = 0; p < std::min(num_pkts, PREFETCH_PKTS); p++) {
+    rte_prefetch0(rte_pktmbuf_mtod(pkts[p], void*));
+  }
+
+  int64_t num_valid = 0;
+  for (int64_t p = 0; p < num_pkts; p++) {
+    if (p + 2 * PREFETCH_PKTS < num_pkts) {
+      rte_prefetch0(pkts[p + 2 * PREFETCH_PKTS]);
+    }
+
+    if (p + PREFETCH_PKTS < num_pkts) {
+      rte_prefetch0(rte_pktmbuf_mtod(pkts[p + PREFETCH_PKTS], void*));
+    }
+
+    info[p].valid = ParseUdpPkt(pkts[p], info[p], seq_offset, seq_size);
+    num_valid += info[p].valid;
+  }
+
+  return num_valid;
+}
+
+int64_t adv_net_parse_udp_burst(std::shared_ptr<AdvNetBurstParams> &burst, AdvNetUdpPktInfo *info,
+                                int seq_offset, int seq_size) {
+  return adv_net_parse_udp_burst(burst.get(), info, seq_offset, seq_size);
+}
+
+size_t adv_net_gather_udp_payloads(AdvNetBurstParams *burst, const AdvNetUdpPktInfo *info,
+                                   void *dst, size_t dst_size, size_t stride) {
+  const int64_t num_pkts = burst->hdr.num_pkts;
+  auto **pkts = reinterpret_cast<rte_mbuf**>(burst->cpu_pkts);
+  auto *out = static_cast<uint8_t*>(dst);
+  size_t off = 0;
+
+  for (int64_t p = 0; p < std::min(num_pkts, PREFETCH_PKTS); p++) {
+    if (info[p].valid) {
+      rte_prefetch0(rte_pktmbuf_mtod_offset(pkts[p], void*, info[p].payload_offset));
+    }
+  }
+
+  for (int64_t p = 0; p < num_pkts; p++) {
+    const int64_t ahead = p + PREFETCH_PKTS;
+    if (ahead < num_pkts && info[ahead].valid) {
+      rte_prefetch0(rte_pktmbuf_mtod_offset(pkts[ahead], void*, info[ahead].payload_offset));
+    }
+
+    if (!info[p].valid) {
+      continue;
+    }
+
+    const size_t len = stride > 0 ? std::min<size_t>(info[p].payload_len, stride) :
+                                    info[p].payload_len;
+    const size_t slot = stride > 0 ? stride : len;
+    if (off + len > dst_size) {
+      break;
+    }
+
+    // Payloads spread over several segments are copied into dst by rte_pktmbuf_read itself
+    const void *src = rte_pktmbuf_read(pkts[p], info[p].payload_offset, len, out + off);
+    if (src != out + off) {
+      rte_memcpy(out + off, src, len);
+    }
+
+    off = std::min(off + slot, dst_size);
+  }
+
+  return off;
+}
+
+size_t adv_net_gather_udp_payloads(std::shared_ptr<AdvNetBurstParams> &burst,
+                                   const AdvNetUdpPktInfo *info, void *dst, size_t dst_size,
+                                   size_t stride) {
+  return adv_net_gather_udp_payloads(burst.get(), info, dst, dst_size, stride);
+}
+
+void adv_net_track_seq(AdvNetSeqTracker &tracker, const AdvNetUdpPktInfo *info, int64_t num_pkts) {
+  constexpr uint64_t window = AdvNetSeqTracker::WINDOW;
+  const uint64_t mask = tracker.seq_bits >= 64 ? ~0ULL : (1ULL << tracker.seq_bits) - 1;
+  const auto seen_word = [&](uint64_t seq) -> uint64_t & {
+    return tracker.seen[(seq % window) / 64];
+  };
+
+  for (int64_t p = 0; p < num_pkts; p++) {
+    if (!info[p].valid) {
+      continue;
+    }
+
+    const uint64_t seq = info[p].seq & mask;
+    const uint64_t bit = 1ULL << (seq % 64);
+    tracker.pkts++;
+    if (!tracker.started) {
+      tracker.started = true;
+      tracker.next_seq = (seq + 1) & mask;
+      seen_word(seq) |= bit;
+      continue;
+    }
+
+    // Packets less than half the sequence space ahead are new; the rest are late
+    const uint64_t ahead = (seq - tracker.next_seq) & mask;
+    if (ahead <= mask >> 1) {
+      if (ahead > 0) {
+        tracker.gaps++;
+        tracker.lost_pkts += ahead;
+      }
+
+      // The skipped numbers take over the window slots of older ones, which are forgotten
+      if (ahead >= window) {
+        tracker.seen.fill(0);
+      } else {
+        for (uint64_t s = tracker.next_seq; s != seq; s = (s + 1) & mask) {
+          seen_word(s) &= ~(1ULL << (s % 64));
+        }
+      }
+
+      seen_word(seq) |= bit;
+      tracker.next_seq = (seq + 1) & mask;
+      continue;
+    }
+
+    // Packets too far behind to be in the window are taken to be late, not duplicates
+    const uint64_t behind = (tracker.next_seq - 1 - seq) & mask;
+    if (behind < window) {
+      if (seen_word(seq) & bit) {
+        tracker.dup_pkts++;
+        continue;
+      }
+
+      seen_word(seq) |= bit;
+    }
+
+    tracker.late_pkts++;
+    tracker.max_reorder = std::max(tracker.max_reorder, behind);
+    if (tracker.lost_pkts > 0) {
+      tracker.lost_pkts--;
+    }
+  }
+}
+
+// One's complement sum of buf in 32-bit words, added into 64-bit sums so no carries are lost.
+// The result is folded to 16 bits by CksumFold. Works in either byte order.
+static uint64_t CksumSum(const uint8_t *buf, size_t len) {
+  uint64_t sum[4] = {};
+  size_t i = 0;
+#if defined(__x86_64__)
+  // Zero-extend each 32-bit word to 64 bits and add two vectors of them at a time
+  const __m128i zero = _mm_setzero_si128();
+  __m128i vsum[2] = {zero, zero};
+  for (; i + 32 <= len; i += 32) {
+    const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf + i));
+    const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf + i + 16));
+    vsum[0] = _mm_add_epi64(vsum[0], _mm_unpacklo_epi32(a, zero));
+    vsum[1] = _mm_add_epi64(vsum[1], _mm_unpackhi_epi32(a, zero));
+    vsum[0] = _mm_add_epi64(vsum[0], _mm_unpacklo_epi32(b, zero));
+    vsum[1] = _mm_add_epi64(vsum[1], _mm_unpackhi_epi32(b, zero));
+  }
+
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(&sum[0]), vsum[0]);
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(&sum[2]), vsum[1]);
+#endif
+
+  for (; i + 16 <= len; i += 16) {
+    uint32_t w[4];
+    memcpy(w, buf + i, sizeof(w));
+    for (int l = 0; l < 4; l++) {
+      sum[l] += w[l];
+    }
+  }
+
+  for (; i + 4 <= len; i += 4) {
+    uint32_t w;
+    memcpy(&w, buf + i, sizeof(w));
+    sum[0] += w;
+  }
+
+  // The last odd bytes are padded with zeros
+  uint32_t tail = 0;
+  memcpy(&tail, buf + i, len - i);
+  return sum[0] + sum[1] + sum[2] + sum[3] + tail;
+}
+
+static uint16_t CksumFold(uint64_t sum) {
+  sum = (sum & 0xffffffff) + (sum >> 32);
+  sum = (sum & 0xffffffff) + (sum >> 32);
+  sum = (sum & 0xffff) + (sum >> 16);
+  sum = (sum & 0xffff) + (sum >> 16);
+  return sum;
+}
+
+static bool UdpChecksumPkt(rte_mbuf *m) {
+  auto *pkt = rte_pktmbuf_mtod(m, uint8_t*);
+  const uint32_t data_len = rte_pktmbuf_data_len(m);
+  const auto *eth = reinterpret_cast<const rte_ether_hdr*>(pkt);
+  if (data_len < sizeof(rte_ether_hdr) + sizeof(rte_ipv4_hdr) ||
+      eth->ether_type != rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV4)) {
+    return false;
+  }
+
+  auto *ip = reinterpret_cast<rte_ipv4_hdr*>(pkt + sizeof(rte_ether_hdr));
+  const uint32_t ihl = ip->ihl * 4;
+  if (ip->version != 4 || ihl < sizeof(rte_ipv4_hdr) ||
+      data_len < sizeof(rte_ether_hdr) + ihl + sizeof(rte_udp_hdr)) {
+    return false;
+  }
+
+  ip->hdr_checksum = 0;
+  ip->hdr_checksum = ~CksumFold(CksumSum(reinterpret_cast<uint8_t*>(ip), ihl));
+  if (ip->next_proto_id != IPPROTO_UDP) {
+    return true;
+  }
+
+  // A UDP checksum of 0 means none over IPv4. It is used when the payload is in later segments,
+  // which may be in GPU memory, or the datagram is fragmented.
+  auto *udp = reinterpret_cast<rte_udp_hdr*>(pkt + sizeof(rte_ether_hdr) + ihl);
+  const uint32_t udp_len = rte_be_to_cpu_16(udp->dgram_len);
+  const uint16_t frag = rte_be_to_cpu_16(ip->fragment_offset);
+  udp->dgram_cksum = 0;
+  if (m->nb_segs > 1 || (frag & (RTE_IPV4_HDR_MF_FLAG | RTE_IPV4_HDR_OFFSET_MASK)) != 0 ||
+      udp_len < sizeof(rte_udp_hdr) ||
+      sizeof(rte_ether_hdr) + ihl + udp_len > data_len) {
+    return true;
+  }
+
+  // The pseudo-header fields are summed as they are stored, which keeps the sum in network order
+  const uint64_t sum = CksumSum(reinterpret_cast<uint8_t*>(udp), udp_len) + ip->src_addr +
+      ip->dst_addr + rte_cpu_to_be_16(IPPROTO_UDP) + udp->dgram_len;
+  const uint16_t cksum = ~CksumFold(sum);
+  udp->dgram_cksum = cksum == 0 ? 0xffff : cksum;
+  return true;
+}
+
+int64_t adv_net_udp_checksum_burst(AdvNetBurstParams *burst) {
+  const int64_t num_pkts = burst->hdr.num_pkts;
+  auto **pkts = reinterpret_cast<rte_mbuf**>(burst->cpu_pkts);
+  for (int64_t p = 0; p < std::min(num_pkts, PREFETCH_PKTS); p++) {
+    rte_prefetch0(rte_pktmbuf_mtod(pkts[p], void*));
+  }
+
+  int64_t num_done = 0;
+  for (int64_t p = 0; p < num_pkts; p++) {
+    if (p + PREFETCH_PKTS < num_pkts) {
+      rte_prefetch0(rte_pktmbuf_mtod(pkts[p + PREFETCH_PKTS], void*));
+    }
+
+    num_done += UdpChecksumPkt(pkts[p]);
+  }
+
+  return num_done;
+}
+
+int64_t adv_net_udp_checksum_burst(std::shared_ptr<AdvNetBurstParams> &burst) {
+  return adv_net_udp_checksum_burst(burst.get());
+}
+
+AdvNetStatus adv_net_create_udp_template(AdvNetUdpTemplate &tmpl, uint16_t port,
+          const std::string &eth_dst, const std::string &ip_src, const std::string &ip_dst,
+          uint16_t src_port, uint16_t dst_port) {
+  static_assert(sizeof(UDPPkt) == AdvNetUdpTemplate::HDR_SIZE, "Template size mismatch");
+  tmpl = AdvNetUdpTemplate{};
+  tmpl.port_id = port;
+  auto *pkt = reinterpret_cast<UDPPkt*>(tmpl.hdr.data());
+
+  struct rte_ether_addr mac;
+  rte_eth_macaddr_get(port, &mac);
+  memcpy(&pkt->eth.src_addr, &mac, sizeof(mac));
+  if (rte_ether_unformat_addr(eth_dst.c_str(), &mac) != 0) {
+    HOLOSCAN_LOG_ERROR("Invalid destination MAC address {}", eth_dst);
+    return AdvNetStatus::INVALID_PARAMETER;
+  }
+
+  memcpy(&pkt->eth.dst_addr, &mac, sizeof(mac));
+  uint32_t src_addr, dst_addr;
+  if (inet_pton(AF_INET, ip_src.c_str(), &src_addr) != 1 ||
+      inet_pton(AF_INET, ip_dst.c_str(), &dst_addr) != 1) {
+    HOLOSCAN_LOG_ERROR("Invalid IPv4 address {} or {}", ip_src, ip_dst);
+    return AdvNetStatus::INVALID_PARAMETER;
+  }
+
+  pkt->eth.ether_type = rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV4);
+  pkt->ip.version = 4;
+  pkt->ip.ihl = 5;
+  pkt->ip.time_to_live = 64;
+  pkt->ip.next_proto_id = IPPROTO_UDP;
+  pkt->ip.src_addr = src_addr;
+  pkt->ip.dst_addr = dst_addr;
+  pkt->udp.src_port = rte_cpu_to_be_16(src_port);
+  pkt->udp.dst_port = rte_cpu_to_be_16(dst_port);
+
+  tmpl.ip_sum = CksumSum(tmpl.hdr.data() + sizeof(rte_ether_hdr), sizeof(rte_ipv4_hdr));
+  tmpl.phdr_sum = static_cast<uint64_t>(src_addr) + dst_addr + rte_cpu_to_be_16(IPPROTO_UDP);
+  tmpl.udp_sum = tmpl.phdr_sum + pkt->udp.src_port + pkt->udp.dst_port;
+  tmpl.hw_cksum = dpdk_mgr.TxChecksumOffload(port);
+  return AdvNetStatus::SUCCESS;
+}
+
+AdvNetStatus adv_net_create_udp_template(AdvNetUdpTemplate &tmpl, uint16_t port, uint16_t q) {
+  const auto *cfg = dpdk_mgr.GetTxQueueConfig(port, q);
+  if (cfg == nullptr) {
+    return AdvNetStatus::NULL_PTR;
+  }
+
+  return adv_net_create_udp_template(tmpl, port, cfg->eth_dst_, cfg->ip_src_, cfg->ip_dst_,
+      cfg->udp_src_port_, cfg->udp_dst_port_);
+}
+
+// Copy the template's headers into a packet and fill in the fields that vary with the payload.
+// Only the payload is summed for a software UDP checksum; the rest comes from the template.
+static inline void FillUdpHdrs(rte_mbuf *m, AdvNetUdpTemplate &tmpl, const uint8_t *payload,
+                               uint16_t len) {
+  auto *pkt = rte_pktmbuf_mtod(m, UDPPkt*);
+  memcpy(pkt, tmpl.hdr.data(), AdvNetUdpTemplate::HDR_SIZE);
+
+  const uint16_t ip_len = rte_cpu_to_be_16(sizeof(rte_ipv4_hdr) + sizeof(rte_udp_hdr) + len);
+  const uint16_t ip_id = rte_cpu_to_be_16(tmpl.next_ip_id++);
+  const uint16_t udp_len = rte_cpu_to_be_16(sizeof(rte_udp_hdr) + len);
+  pkt->ip.total_length = ip_len;
+  pkt->ip.packet_id = ip_id;
+  pkt->udp.dgram_len = udp_len;
+
+  if (tmpl.hw_cksum) {
+    m->ol_flags = RTE_MBUF_F_TX_IPV4 | RTE_MBUF_F_TX_IP_CKSUM | RTE_MBUF_F_TX_UDP_CKSUM;
+    m->l2_len = sizeof(rte_ether_hdr);
+    m->l3_len = sizeof(rte_ipv4_hdr);
+    pkt->udp.dgram_cksum = CksumFold(tmpl.phdr_sum + udp_len);
+    return;
+  }
+
+  // The UDP length is in both the pseudo-header and the UDP header
+  m->ol_flags = 0;
+  pkt->ip.hdr_checksum = ~CksumFold(tmpl.ip_sum + ip_len + ip_id);
+  const uint16_t cksum = ~CksumFold(tmpl.udp_sum + 2 * udp_len + CksumSum(payload, len));
+  pkt->udp.dgram_cksum = cksum == 0 ? 0xffff : cksum;
+}
+
+AdvNetStatus adv_net_fill_udp_burst(AdvNetBurstParams *burst, AdvNetUdpTemplate &tmpl,
+          const void *const *payloads, const uint16_t *lens) {
+  if (burst->hdr.port_id != tmpl.port_id) {
+    return AdvNetStatus::INVALID_PARAMETER;
+  }
+
+  const int64_t num_pkts = burst->hdr.num_pkts;
+  auto **pkts = reinterpret_cast<rte_mbuf**>(burst->cpu_pkts);
+  for (int64_t p = 0; p < num_pkts; p++) {
+    if (p + PREFETCH_PKTS < num_pkts) {
+      rte_prefetch0(rte_pktmbuf_mtod(pkts[p + PREFETCH_PKTS], void*));
+    }
+
+    auto *payload = rte_pktmbuf_mtod_offset(pkts[p], uint8_t*, sizeof(UDPPkt));
+    rte_memcpy(payload, payloads[p], lens[p]);
+    if (tmpl.seq_offset >= 0 && tmpl.seq_offset + sizeof(uint32_t) <= lens[p]) {
+      const uint32_t seq = rte_cpu_to_be_32(tmpl.next_seq++);
+      memcpy(payload + tmpl.seq_offset, &seq, sizeof(seq));
+    }
+
+    FillUdpHdrs(pkts[p], tmpl, payload, lens[p]);
+    pkts[p]->data_len = sizeof(UDPPkt) + lens[p];
+    pkts[p]->pkt_len = pkts[p]->data_len;
+  }
+
+  burst->hdr.hdrs_complete = true;
+  return AdvNetStatus::SUCCESS;
+}
+
+AdvNetStatus adv_net_fill_udp_burst(std::shared_ptr<AdvNetBurstParams> &burst,
+          AdvNetUdpTemplate &tmpl, const void *const *payloads, const uint16_t *lens) {
+  return adv_net_fill_udp_burst(burst.get(), tmpl, payloads, lens);
+}
+
+// Shared by the attached payloads of a burst. DPDK calls TxAttachFree once the last is freed.
+struct TxAttachDone {
+  struct rte_mbuf_ext_shared_info shinfo;
+  void (*done)(void *opaque);
+  void *opaque;
+};
+
+static void TxAttachFree(void *, void *opaque) {
+  auto *att = static_cast<TxAttachDone*>(opaque);
+  if (att->done != nullptr) {
+    att->done(att->opaque);
+  }
+
+  rte_free(att);
+}
+
+AdvNetStatus adv_net_attach_udp_burst(AdvNetBurstParams *burst, AdvNetUdpTemplate &tmpl,
+          void *const *payloads, const uint16_t *lens, void (*done)(void *opaque), void *opaque) {
+  const int64_t num_pkts = burst->hdr.num_pkts;
+  if (burst->hdr.port_id != tmpl.port_id || num_pkts > UINT16_MAX) {
+    return AdvNetStatus::INVALID_PARAMETER;
+  }
+
+  // Payloads are attached by virtual address, which is only the IOVA the NIC uses in VA mode.
+  // Checking once here saves a page table walk in rte_mem_virt2iova for every packet.
+  if (!dpdk_mgr.TxMultiSegOffload(tmpl.port_id) || rte_eal_iova_mode() != RTE_IOVA_VA) {
+    return AdvNetStatus::NOT_SUPPORTED;
+  }
+
+  if (num_pkts == 0) {
+    if (done != nullptr) {
+      done(opaque);
+    }
+
+    return AdvNetStatus::SUCCESS;
+  }
+
+  // The payload segments come from the same pool as the header packets
+  auto **pkts = reinterpret_cast<rte_mbuf**>(burst->cpu_pkts);
+  thread_local std::vector<rte_mbuf*> segs;
+  segs.resize(num_pkts);
+  if (rte_pktmbuf_alloc_bulk(pkts[0]->pool, segs.data(), num_pkts) != 0) {
+    return AdvNetStatus::NO_FREE_CPU_PACKET_BUFFERS;
+  }
+
+  auto *att = static_cast<TxAttachDone*>(rte_zmalloc(nullptr, sizeof(TxAttachDone), 0));
+  if (att == nullptr) {
+    rte_pktmbuf_free_bulk(segs.data(), num_pkts);
+    return AdvNetStatus::NULL_PTR;
+  }
+
+  att->shinfo.free_cb = TxAttachFree;
+  att->shinfo.fcb_opaque = att;
+  att->done = done;
+  att->opaque = opaque;
+  rte_mbuf_ext_refcnt_set(&att->shinfo, num_pkts);
+
+  for (int64_t p = 0; p < num_pkts; p++) {
+    if (p + PREFETCH_PKTS < num_pkts) {
+      rte_prefetch0(rte_pktmbuf_mtod(pkts[p + PREFETCH_PKTS], void*));
+    }
+
+    rte_pktmbuf_attach_extbuf(segs[p], payloads[p],
+        static_cast<rte_iova_t>(reinterpret_cast<uintptr_t>(payloads[p])), lens[p], &att->shinfo);
+    segs[p]->data_len = lens[p];
+    segs[p]->pkt_len = lens[p];
+
+    FillUdpHdrs(pkts[p], tmpl, static_cast<const uint8_t*>(payloads[p]), lens[p]);
+    pkts[p]->data_len = sizeof(UDPPkt);
+    pkts[p]->pkt_len = sizeof(UDPPkt);
+    rte_pktmbuf_chain(pkts[p], segs[p]);
+  }
+
+  burst->hdr.hdrs_complete = true;
+  return AdvNetStatus::SUCCESS;
+}
+
+AdvNetStatus adv_net_attach_udp_burst(std::shared_ptr<AdvNetBurstParams> &burst,
+          AdvNetUdpTemplate &tmpl, void *const *payloads, const uint16_t *lens,
+          void (*done)(void *opaque), void *opaque) {
+  return adv_net_attach_udp_burst(burst.get(), tmpl, payloads, lens, done, opaque);
+}
+
+AdvNetStatus adv_net_register_tx_memory(void *addr, size_t len) {
+  return dpdk_mgr.RegisterTxMemory(addr, len) ? AdvNetStatus::SUCCESS :
+                                                AdvNetStatus::INVALID_PARAMETER;
+}
+
 std::optional<uint16_t> adv_net_get_port_from_ifname(const std::string &name) {
   uint16_t port;
   auto ret = rte_eth_dev_get_port_by_name(name.c_str(), &port);
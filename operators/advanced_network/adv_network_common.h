@@ -16,10 +16,12 @@
  */
 
 #pragma once
+#include <array>
 #include <vector>
 #include <string>
 #include <memory>
 #include <optional>
+#include <stdexcept>
 #include <tuple>
 #include <stdint.h>
 #include "holoscan/holoscan.hpp"
@@ -35,6 +37,14 @@ static inline constexpr uint32_t MAX_NUM_RX_QUEUES = 32;
 static inline constexpr uint32_t MAX_NUM_TX_QUEUES = 32;
 static inline constexpr uint32_t MAX_INTERFACES = 4;
 
+/**
+ * @brief Buckets in a burst fill latency histogram
+ *
+ * Bucket 0 counts bursts filled in under 1us, bucket b those filled in [2^(b-1), 2^b) us, and the
+ * last bucket everything slower.
+ */
+static inline constexpr uint32_t ADV_NET_LATENCY_BUCKETS = 16;
+
 /**
  * @brief Header of AdvNetBurstParams
  *
@@ -43,6 +53,7 @@ struct AdvNetBurstParamsHdr {
   size_t        num_pkts;
   uint16_t       port_id;
   uint16_t      q_id;
+  bool          hdrs_complete;  // Headers and checksums are filled in, so TX leaves them alone
 };
 
 struct AdvNetBurstParams {
@@ -60,6 +71,12 @@ inline auto CreateSharedBurstParams() {
   return std::make_shared<AdvNetBurstParams>();
 }
 
+/**
+ * @brief Bursts emitted together by the RX operator when rx_bursts_per_tick is above 1
+ *
+ */
+using AdvNetBurstList = std::vector<std::shared_ptr<AdvNetBurstParams>>;
+
 
 /**
  * @brief Return status codes from advanced network operators
@@ -71,6 +88,8 @@ enum class AdvNetStatus {
   NO_FREE_BURST_BUFFERS,
   NO_FREE_CPU_PACKET_BUFFERS,
   NO_FREE_GPU_PACKET_BUFFERS,
+  INVALID_PARAMETER,
+  NOT_SUPPORTED,
 };
 
 /**
@@ -93,7 +112,155 @@ enum class AdvNetDirection : uint8_t {
   TX_RX = 2,
 };
 
+/**
+ * @brief What an RX worker does when every burst buffer of its queue is in use
+ *
+ */
+enum class AdvNetOverloadPolicy : uint8_t {
+  DROP_NEWEST = 0,  // Drop arriving packets until a buffer is free
+  DROP_OLDEST = 1,  // Drop the oldest burst not yet taken by the RX operator, and reuse it
+  BLOCK = 2,        // Wait up to overload_timeout_us for a buffer, then drop arriving packets
+};
+
+/**
+ * @brief Counters of a single RX queue
+ *
+ * Bursts the RX operator does not keep up with hold the queue's burst buffers. When they are all
+ * in use the queue's overload policy applies, and the drop and stall counters show how often. They
+ * are a guide to sizing num_concurrent_batches.
+ */
+struct AdvNetRxQueueStats {
+  uint16_t port_id;
+  uint16_t q_id;
+  uint64_t pkts;             // Packets passed to the RX operator
+  uint64_t bursts;           // Bursts passed to the RX operator
+  uint64_t timeout_bursts;   // Bursts passed on partly full because timeout_us passed
+  uint64_t dropped_pkts;     // Packets dropped because no burst buffer was free
+  uint64_t recycled_bursts;  // Bursts dropped after being queued, under drop_oldest
+  uint64_t stalls;           // Times the worker waited for a burst buffer, under block
+  uint64_t stall_ns;         // Total time spent waiting for a burst buffer, under block
+  uint64_t bytes;            // Bytes in the packets passed to the RX operator
+  uint32_t ring_bursts;      // Bursts waiting for the RX operator
+  uint32_t free_bursts;      // Burst buffers free for the worker to fill
+  // Time from the first packet of a burst arriving to the burst being passed on
+  std::array<uint64_t, ADV_NET_LATENCY_BUCKETS> fill_latency_hist;
+  uint64_t fill_latency_ns;  // Sum of the fill latency of every burst
+};
+
+/**
+ * @brief Counters of a single TX queue
+ *
+ */
+struct AdvNetTxQueueStats {
+  uint16_t port_id;
+  uint16_t q_id;
+  uint64_t pkts;             // Packets handed to the NIC
+  uint64_t bytes;            // Bytes in the packets handed to the NIC
+  uint64_t bursts;           // Bursts taken from the TX operator
+  uint32_t ring_bursts;      // Bursts waiting for the worker
+  uint32_t free_bursts;      // Burst buffers free for the TX operator
+  uint32_t free_pkts;        // Packet buffers free for the TX operator
+};
+
+/**
+ * @brief Counters kept by the NIC for a port
+ *
+ */
+struct AdvNetPortStats {
+  uint16_t port_id;
+  uint64_t rx_pkts;
+  uint64_t tx_pkts;
+  uint64_t rx_bytes;
+  uint64_t tx_bytes;
+  uint64_t rx_missed;        // Packets dropped by the NIC because the RX queue was full
+  uint64_t rx_errors;
+  uint64_t tx_errors;
+  uint64_t rx_nombuf;        // Packets dropped because no mbuf was free
+};
+
+/**
+ * @brief Snapshot of every port and queue counter
+ *
+ */
+struct AdvNetTelemetry {
+  uint64_t timestamp_ns;     // Wall clock time the snapshot was taken
+  std::vector<AdvNetPortStats> ports;
+  std::vector<AdvNetRxQueueStats> rx_queues;
+  std::vector<AdvNetTxQueueStats> tx_queues;
+};
+
+/**
+ * @brief UDP/IPv4 header fields of one packet, filled in by adv_net_parse_udp_burst
+ *
+ * Addresses and ports are in host byte order.
+ */
+struct AdvNetUdpPktInfo {
+  uint32_t src_addr;
+  uint32_t dst_addr;
+  uint16_t src_port;
+  uint16_t dst_port;
+  uint16_t payload_offset;  // Offset of the UDP payload from the start of the packet
+  uint16_t payload_len;     // UDP payload length
+  uint64_t seq;             // Sequence number read from the payload, if one was asked for
+  bool valid;               // Packet is UDP/IPv4 and its lengths are consistent
+};
+
+/**
+ * @brief Sequence number state of one stream, updated by adv_net_track_seq
+ *
+ * A packet ahead of the one expected opens a gap and counts the missing packets as lost. A packet
+ * behind it is late, and is taken to fill an earlier gap, so it comes back off the lost count.
+ * Arrivals within WINDOW sequence numbers of the newest are remembered, so a second copy of one of
+ * them is counted as a duplicate instead. Sequence numbers wrap at seq_bits.
+ */
+struct AdvNetSeqTracker {
+  static constexpr int WINDOW = 1024;
+  int seq_bits = 32;
+  bool started = false;
+  uint64_t next_seq = 0;    // Sequence number expected next
+  uint64_t pkts = 0;        // Packets seen
+  uint64_t gaps = 0;        // Times one or more packets were missing
+  uint64_t lost_pkts = 0;   // Packets missing and not seen late since
+  uint64_t late_pkts = 0;   // Packets that arrived after a later one
+  uint64_t dup_pkts = 0;    // Packets already seen within the window
+  uint64_t max_reorder = 0; // Most sequence numbers a late packet was behind the newest
+  std::array<uint64_t, WINDOW / 64> seen{};  // Arrivals in the window, a bit per seq % WINDOW
+};
+
+/**
+ * @brief Ethernet/IPv4/UDP headers of one TX flow, built once by adv_net_create_udp_template
+ *
+ * The headers are copied into each packet by adv_net_fill_udp_burst or adv_net_attach_udp_burst,
+ * and only the lengths, IP ID, checksums and sequence number are filled in per packet. The sums
+ * of the constant header words are kept, so the checksums only add the varying fields. A template
+ * counts IP IDs and sequence numbers, so it is used by one thread at a time.
+ */
+struct AdvNetUdpTemplate {
+  static constexpr int HDR_SIZE = 42;
+  uint16_t port_id = 0;
+  std::array<uint8_t, HDR_SIZE> hdr{};  // Headers with the lengths, ID and checksums zeroed
+  uint64_t ip_sum = 0;       // Sum of the constant IPv4 header words
+  uint64_t phdr_sum = 0;     // Sum of the constant UDP pseudo-header words
+  uint64_t udp_sum = 0;      // phdr_sum plus the UDP ports
+  bool hw_cksum = false;     // The port computes the checksums
+  uint16_t next_ip_id = 0;
+  int seq_offset = -1;       // Payload offset of a 32-bit big-endian sequence number. -1 is none
+  uint32_t next_seq = 0;
+};
+
 namespace detail {
+  inline AdvNetOverloadPolicy OverloadPolicyStringToType(const std::string &policy) {
+    if (policy == "drop_newest") {
+      return AdvNetOverloadPolicy::DROP_NEWEST;
+    } else if (policy == "drop_oldest") {
+      return AdvNetOverloadPolicy::DROP_OLDEST;
+    } else if (policy == "block") {
+      return AdvNetOverloadPolicy::BLOCK;
+    }
+
+    throw std::invalid_argument("Invalid overload_policy " + policy);
+  }
+
   inline AdvNetDirection DirectionStringToType(const std::string &dir) {
     if (dir == "rx") {
       return AdvNetDirection::RX;
@@ -198,12 +365,13 @@ uint16_t adv_net_get_gpu_packet_len(std::shared_ptr<AdvNetBurstParams> &burst, i
  * @brief Populate a TX packet burst buffer
  *
  * Populates a transmit packet burst buffer with allocated packets. The user can take these
- * allocated packets and fill with the desired data/headers.
+ * allocated packets and fill with the desired data/headers. Packets are allocated from the
+ * queue set in the burst header, so adv_net_set_hdr must be called first.
  *
  * @param burst Burst structure to populate
  * @return AdvNetStatus indicating status. Valid values are:
  *    SUCCESS: Packets allocated
- *    NULL_PTR: Burst or packet pools uninitialized
+ *    NULL_PTR: Port and queue in the burst header are not a configured TX queue
  *    NO_FREE_BURST_BUFFERS: No burst buffers to allocate
  *    NO_FREE_CPU_PACKET_BUFFERS: Not enough CPU packet buffers available
  */
@@ -233,10 +401,12 @@ AdvNetStatus adv_net_set_cpu_udp_payload(std::shared_ptr<AdvNetBurstParams> &bur
  * use this function to loop or return later to try again.
  *
  * @param num_pkts Number of packets to test allocation for
+ * @param port Port ID of the TX queue
+ * @param q Queue ID of the TX queue
  * @return true Burst is available
- * @return false Burst is not available
+ * @return false Burst is not available, or the queue is not configured
  */
-bool adv_net_tx_burst_available(int num_pkts);
+bool adv_net_tx_burst_available(int num_pkts, uint16_t port = 0, uint16_t q = 0);
 
 /**
  * @brief Free all CPU packets and burst
@@ -315,6 +485,37 @@ void adv_net_free_rx_burst(std::shared_ptr<AdvNetBurstParams> &burst);
 void adv_net_free_tx_burst(AdvNetBurstParams *burst);
 void adv_net_free_tx_burst(std::shared_ptr<AdvNetBurstParams> &burst);
 
+/**
+ * @brief Get the counters of every RX queue
+ *
+ * Counters are read while the RX workers keep running, so they may be slightly out of step with
+ * each other.
+ *
+ * @return One entry per configured RX queue
+ */
+std::vector<AdvNetRxQueueStats> adv_net_get_rx_queue_stats();
+
+/**
+ * @brief Get the counters of every port, RX queue and TX queue
+ *
+ * Safe to call from any operator while the workers are running. Like adv_net_get_rx_queue_stats,
+ * counters are not read atomically with each other.
+ *
+ * @return Snapshot of all counters
+ */
+AdvNetTelemetry adv_net_get_telemetry();
+
+/**
+ * @brief Format telemetry in the Prometheus text exposition format
+ *
+ * Counters are labelled by port, and by queue where they belong to one. This is the format
+ * written to telemetry_file.
+ *
+ * @param telemetry Snapshot from adv_net_get_telemetry
+ * @return Text to serve or write to a file for a node exporter textfile collector
+ */
+std::string adv_net_telemetry_to_prometheus(const AdvNetTelemetry &telemetry);
+
 /**
  * @brief Get the number of packets in a burst
  *
@@ -344,6 +545,150 @@ void adv_net_set_hdr(AdvNetBurstParams *burst, uint16_t port, uint16_t q, int64_
 void adv_net_set_hdr(std::shared_ptr<AdvNetBurstParams> &burst,
           uint16_t port, uint16_t q, int64_t num);
 
+/**
+ * @brief Validate and extract the UDP/IPv4 headers of every packet in a burst
+ *
+ * Replaces the per-packet adv_net_get_cpu_pkt_ptr/ntohs loop most RX consumers write. Packets may
+ * carry one VLAN tag and IP options. Headers of upcoming packets are prefetched while the current
+ * one is parsed. Only the first segment of each packet is read, so with header-data split the
+ * headers, and the sequence number if any, must be in the CPU segment.
+ *
+ * @param burst Burst structure with packets
+ * @param info Output array with one entry per packet in the burst
+ * @param seq_offset Offset in the UDP payload of a big-endian sequence number, or -1 for none
+ * @param seq_size Size of the sequence number in bytes: 2, 4 or 8
+ * @return Number of valid packets
+ */
+int64_t adv_net_parse_udp_burst(AdvNetBurstParams *burst, AdvNetUdpPktInfo *info,
+          int seq_offset = -1, int seq_size = 4);
+int64_t adv_net_parse_udp_burst(std::shared_ptr<AdvNetBurstParams> &burst, AdvNetUdpPktInfo *info,
+          int seq_offset = -1, int seq_size = 4);
+
+/**
+ * @brief Copy the UDP payloads of a burst into a contiguous host buffer
+ *
+ * Payloads of valid packets are copied in packet order; invalid packets are skipped. Payloads must
+ * be in host memory, so this does not apply to header-data split queues. Payloads longer than
+ * stride are truncated, and copying stops at the first payload that does not fit.
+ *
+ * @param burst Burst structure with packets
+ * @param info Headers from adv_net_parse_udp_burst
+ * @param dst Destination buffer
+ * @param dst_size Size of dst in bytes
+ * @param stride Bytes between the starts of consecutive payloads in dst, or 0 to pack them
+ * @return Bytes of dst used
+ */
+size_t adv_net_gather_udp_payloads(AdvNetBurstParams *burst, const AdvNetUdpPktInfo *info,
+          void *dst, size_t dst_size, size_t stride = 0);
+size_t adv_net_gather_udp_payloads(std::shared_ptr<AdvNetBurstParams> &burst,
+          const AdvNetUdpPktInfo *info, void *dst, size_t dst_size, size_t stride = 0);
+
+/**
+ * @brief Update a stream's sequence tracker with the packets of a burst
+ *
+ * @param tracker Tracker of the stream the burst belongs to
+ * @param info Headers from adv_net_parse_udp_burst, parsed with a sequence number offset
+ * @param num_pkts Number of entries in info. Invalid packets are skipped
+ */
+void adv_net_track_seq(AdvNetSeqTracker &tracker, const AdvNetUdpPktInfo *info, int64_t num_pkts);
+
+/**
+ * @brief Compute the IPv4 header and UDP checksums of a burst's packets in software
+ *
+ * The TX operator does this itself for ports without checksum offload, so applications only need
+ * it for packets that bypass the operator. Packets that are not IPv4 are left alone, and only
+ * the IPv4 checksum of non-UDP packets is written. The UDP checksum is set to 0, meaning none,
+ * for multi-segment packets and fragments, since their payload is not all in the first segment.
+ *
+ * @param burst Burst structure with packets in CPU memory
+ * @return Number of packets whose checksums were written
+ */
+int64_t adv_net_udp_checksum_burst(AdvNetBurstParams *burst);
+int64_t adv_net_udp_checksum_burst(std::shared_ptr<AdvNetBurstParams> &burst);
+
+/**
+ * @brief Build the headers of a UDP flow sent from a port
+ *
+ * @param tmpl Template to fill in
+ * @param port Port the flow is sent from. Its MAC address is the source address
+ * @param eth_dst Destination MAC address, as "xx:xx:xx:xx:xx:xx"
+ * @param ip_src Source IPv4 address
+ * @param ip_dst Destination IPv4 address
+ * @param src_port UDP source port
+ * @param dst_port UDP destination port
+ * @return INVALID_PARAMETER if an address cannot be parsed, otherwise SUCCESS
+ */
+AdvNetStatus adv_net_create_udp_template(AdvNetUdpTemplate &tmpl, uint16_t port,
+          const std::string &eth_dst, const std::string &ip_src, const std::string &ip_dst,
+          uint16_t src_port, uint16_t dst_port);
+
+/**
+ * @brief Build the headers of a UDP flow from the addresses configured for a TX queue
+ *
+ * @param tmpl Template to fill in
+ * @param port Port of the TX queue
+ * @param q TX queue whose eth_dst_addr, ip_src_addr, ip_dst_addr and UDP ports are used
+ * @return NULL_PTR if the queue is not configured, otherwise as adv_net_create_udp_template
+ */
+AdvNetStatus adv_net_create_udp_template(AdvNetUdpTemplate &tmpl, uint16_t port, uint16_t q);
+
+/**
+ * @brief Build every packet of a TX burst from a template, copying the payloads in
+ *
+ * The burst's packets are complete afterwards, so the TX operator sends them as they are.
+ *
+ * @param burst Burst from adv_net_get_tx_pkt_burst
+ * @param tmpl Template of the flow, on the same port as the burst
+ * @param payloads Payload of each packet
+ * @param lens Length of each payload
+ * @return INVALID_PARAMETER if the template is for another port, otherwise SUCCESS
+ */
+AdvNetStatus adv_net_fill_udp_burst(AdvNetBurstParams *burst, AdvNetUdpTemplate &tmpl,
+          const void *const *payloads, const uint16_t *lens);
+AdvNetStatus adv_net_fill_udp_burst(std::shared_ptr<AdvNetBurstParams> &burst,
+          AdvNetUdpTemplate &tmpl, const void *const *payloads, const uint16_t *lens);
+
+/**
+ * @brief Build every packet of a TX burst from a template, attaching the payloads without a copy
+ *
+ * Each packet gets a second segment pointing at its payload, so payloads of any size cost the
+ * same. The payloads are sent as they are, so the template's sequence number is not written.
+ * They must stay unchanged until done is called, which happens once the NIC has sent every packet
+ * of the burst, on whichever thread frees the last one. Payload memory must come from DPDK or
+ * be registered with adv_net_register_tx_memory, and the port must support multi-segment packets.
+ * The EAL must use virtual addresses as IOVAs, so payload addresses are given to the NIC as they
+ * are. The segments come from the queue's packet pool, so it needs a second buffer for each packet.
+ *
+ * @param burst Burst from adv_net_get_tx_pkt_burst
+ * @param tmpl Template of the flow, on the same port as the burst
+ * @param payloads Payload of each packet
+ * @param lens Length of each payload
+ * @param done Called with opaque once the payloads are no longer needed. May be nullptr
+ * @param opaque Argument to done
+ * @return NOT_SUPPORTED if the port cannot send multi-segment packets or the EAL is not in
+ * IOVA as VA mode,
+ * NO_FREE_CPU_PACKET_BUFFERS if the pool has no buffers for the segments, NULL_PTR if the
+ * completion cannot be allocated, otherwise as adv_net_fill_udp_burst
+ */
+AdvNetStatus adv_net_attach_udp_burst(AdvNetBurstParams *burst, AdvNetUdpTemplate &tmpl,
+          void *const *payloads, const uint16_t *lens, void (*done)(void *opaque), void *opaque);
+AdvNetStatus adv_net_attach_udp_burst(std::shared_ptr<AdvNetBurstParams> &burst,
+          AdvNetUdpTemplate &tmpl, void *const *payloads, const uint16_t *lens,
+          void (*done)(void *opaque), void *opaque);
+
+/**
+ * @brief Register application memory that TX payloads are attached from
+ *
+ * The memory is mapped for DMA by every physical TX port. This needs the EAL to use virtual
+ * addresses as IOVAs, which is the default with an IOMMU.
+ *
+ * @param addr Start of the memory. Must be page aligned
+ * @param len Length of the memory. Must be a multiple of the page size
+ * @return INVALID_PARAMETER if the EAL is not in IOVA as VA mode or the memory cannot be
+ * registered or mapped, otherwise SUCCESS
+ */
+AdvNetStatus adv_net_register_tx_memory(void *addr, size_t len);
+
 std::optional<uint16_t> adv_net_get_port_from_ifname(const std::string &name);
 
 struct CommonQueueConfig {
@@ -361,6 +706,12 @@ struct CommonQueueConfig {
 
 struct RxQueueConfig {
   CommonQueueConfig common_;
+  AdvNetOverloadPolicy overload_policy_ = AdvNetOverloadPolicy::DROP_NEWEST;
+  uint32_t overload_timeout_us_ = 1000;  // Longest wait for a burst buffer under block
+  uint32_t timeout_us_ = 0;              // Longest a batch waits to fill. 0 is no limit
+  std::string replay_file_;              // Capture file to receive from instead of the NIC
+  double replay_speed_ = 1.0;            // Multiple of the captured rate. 0 is full speed
+  bool replay_loop_ = false;             // Start the file again once it has been replayed
 };
 
 struct TxQueueConfig {
@@ -402,6 +753,14 @@ struct CommonConfig {
   int version;
   int master_core_;
   AdvNetDirection dir;
+  std::vector<std::string> vdevs_;  // DPDK virtual devices to create, e.g. "net_ring0"
+  bool no_huge_ = false;            // Use regular pages instead of hugepages
+  int memory_mb_ = 0;               // Memory to reserve in MB. 0 uses the DPDK default
+  int rx_bursts_per_tick_ = 1;      // Most bursts the RX operator emits per compute()
+  int telemetry_interval_ms_ = 0;   // How often telemetry is exported. 0 disables it
+  std::string telemetry_file_;      // Prometheus text file to export to. Empty logs instead
+  std::string capture_file_;        // pcapng file to write received packets to. Empty disables
+  int capture_core_ = -1;           // CPU core of the capture writer
 };
 
 struct AdvNetRxConfig {
@@ -441,6 +800,23 @@ auto adv_net_get_rx_tx_cfg_en(const Config &config) {
 
   return std::make_tuple(rx, tx);
 }
+
+/**
+ * @brief Most bursts the RX operator emits per compute(). Above 1, the RX operator emits an
+ * AdvNetBurstList rather than a single AdvNetBurstParams
+ */
+template <typename Config>
+int adv_net_get_rx_bursts_per_tick(const Config &config) {
+  int bursts = 1;
+  for (const auto &yaml_node : config.yaml_nodes()) {
+    auto node = yaml_node["advanced_network"]["cfg"]["rx_bursts_per_tick"];
+    if (node.IsDefined()) {
+      bursts = node.template as<int>();
+    }
+  }
+
+  return bursts;
+}
 };  // namespace holoscan::ops
 
 
@@ -471,6 +847,16 @@ struct YAML::convert<holoscan::ops::AdvNetConfigYaml> {
     try {
       input_spec.common_.version        = node["version"].as<int32_t>();
       input_spec.common_.master_core_   = node["master_core"].as<int32_t>();
+      if (node["vdevs"].IsDefined()) {
+        input_spec.common_.vdevs_       = node["vdevs"].as<std::vector<std::string>>();
+      }
+      input_spec.common_.no_huge_       = node["no_huge"].as<bool>(false);
+      input_spec.common_.memory_mb_     = node["memory_mb"].as<int32_t>(0);
+      input_spec.common_.rx_bursts_per_tick_ = node["rx_bursts_per_tick"].as<int32_t>(1);
+      input_spec.common_.telemetry_interval_ms_ = node["telemetry_interval_ms"].as<int32_t>(0);
+      input_spec.common_.telemetry_file_ = node["telemetry_file"].as<std::string>("");
+      input_spec.common_.capture_file_  = node["capture_file"].as<std::string>("");
+      input_spec.common_.capture_core_  = node["capture_core"].as<int32_t>(-1);
 
       try {
         const auto &rx = node["rx"];
@@ -494,6 +880,13 @@ struct YAML::convert<holoscan::ops::AdvNetConfigYaml> {
             q.common_.num_concurrent_batches_  = q_item["num_concurrent_batches"].as<int>();
             q.common_.max_packet_size_  = q_item["max_packet_size"].as<int>();
             q.common_.batch_size_       = q_item["batch_size"].as<int>();
+            q.overload_policy_          = holoscan::ops::detail::OverloadPolicyStringToType(
+                q_item["overload_policy"].as<std::string>("drop_newest"));
+            q.overload_timeout_us_      = q_item["overload_timeout_us"].as<uint32_t>(1000);
+            q.timeout_us_               = q_item["timeout_us"].as<uint32_t>(0);
+            q.replay_file_              = q_item["replay_file"].as<std::string>("");
+            q.replay_speed_             = q_item["replay_speed"].as<double>(1.0);
+            q.replay_loop_              = q_item["replay_loop"].as<bool>(false);
 
             rx_cfg.queues_.emplace_back(q);
           }
@@ -0,0 +1,173 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <pthread.h>
+#include <sched.h>
+#include <string.h>
+#include <algorithm>
+#include "adv_network_cpu_reorder.h"
+#include "holoscan/holoscan.hpp"
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+namespace holoscan::ops {
+
+// Packets ahead of the one being copied that are prefetched
+static constexpr uint32_t PREFETCH_PKTS = 4;
+
+#if defined(__x86_64__)
+// Copy with streaming stores, which bypass the cache. Only the aligned middle is streamed.
+static void StreamCopy(uint8_t *dst, const uint8_t *src, size_t len) {
+  const size_t head = std::min(len, (16 - reinterpret_cast<uintptr_t>(dst) % 16) % 16);
+  memcpy(dst, src, head);
+  dst += head;
+  src += head;
+  len -= head;
+
+  for (; len >= 64; len -= 64, dst += 64, src += 64) {
+    const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+    const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 16));
+    const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 32));
+    const __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 48));
+    _mm_stream_si128(reinterpret_cast<__m128i*>(dst), a);
+    _mm_stream_si128(reinterpret_cast<__m128i*>(dst + 16), b);
+    _mm_stream_si128(reinterpret_cast<__m128i*>(dst + 32), c);
+    _mm_stream_si128(reinterpret_cast<__m128i*>(dst + 48), d);
+  }
+
+  for (; len >= 16; len -= 16, dst += 16, src += 16) {
+    _mm_stream_si128(reinterpret_cast<__m128i*>(dst),
+                     _mm_loadu_si128(reinterpret_cast<const __m128i*>(src)));
+  }
+
+  memcpy(dst, src, len);
+}
+#endif
+
+CpuPacketReorder::CpuPacketReorder(int num_threads, const std::vector<int> &cpus,
+                                   size_t nt_threshold)
+    : nt_threshold_(nt_threshold) {
+  for (int t = 1; t < num_threads; t++) {
+    workers_.emplace_back(&CpuPacketReorder::WorkerLoop, this, t);
+    if (static_cast<size_t>(t - 1) < cpus.size()) {
+      cpu_set_t set;
+      CPU_ZERO(&set);
+      CPU_SET(cpus[t - 1], &set);
+      if (pthread_setaffinity_np(workers_.back().native_handle(), sizeof(set), &set) != 0) {
+        HOLOSCAN_LOG_WARN("Failed to pin reorder thread {} to core {}", t, cpus[t - 1]);
+      }
+    }
+  }
+
+  HOLOSCAN_LOG_INFO("CPU packet reorder using {} threads, non-temporal stores from {} bytes",
+      NumThreads(), nt_threshold_);
+}
+
+CpuPacketReorder::~CpuPacketReorder() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+
+  start_cv_.notify_all();
+  for (auto &w : workers_) {
+    w.join();
+  }
+}
+
+void CpuPacketReorder::CopyRange(const Job &job, uint32_t first, uint32_t last) {
+  for (uint32_t p = first; p < last; p++) {
+    // The packets are scattered, so the hardware prefetcher cannot find the next one
+    if (p + PREFETCH_PKTS < last) {
+      const auto next = static_cast<const uint8_t*>(job.in[p + PREFETCH_PKTS]);
+      __builtin_prefetch(next);
+      __builtin_prefetch(next + 64);
+    }
+
+    uint8_t *dst = job.out + static_cast<size_t>(p) * job.pkt_len;
+    const auto src = static_cast<const uint8_t*>(job.in[p]);
+#if defined(__x86_64__)
+    if (job.nt) {
+      StreamCopy(dst, src, job.pkt_len);
+      continue;
+    }
+#endif
+    memcpy(dst, src, job.pkt_len);
+  }
+
+#if defined(__x86_64__)
+  // Streaming stores are weakly ordered, so they must be visible before the batch is reported done
+  if (job.nt) {
+    _mm_sfence();
+  }
+#endif
+}
+
+void CpuPacketReorder::CopyShare(const Job &job, int idx) const {
+  const uint64_t threads = NumThreads();
+  CopyRange(job, job.num_pkts * idx / threads, job.num_pkts * (idx + 1) / threads);
+}
+
+void CpuPacketReorder::WorkerLoop(int idx) {
+  uint64_t seen = 0;
+  while (true) {
+    Job job;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      start_cv_.wait(lock, [&] { return stop_ || generation_ != seen; });
+      if (stop_) {
+        return;
+      }
+
+      seen = generation_;
+      job = job_;
+    }
+
+    CopyShare(job, idx);
+    busy_.fetch_sub(1, std::memory_order_release);
+  }
+}
+
+void CpuPacketReorder::Reorder(void *out, const void *const *in, uint16_t pkt_len,
+                               uint32_t num_pkts) {
+  const size_t bytes = static_cast<size_t>(pkt_len) * num_pkts;
+  const Job job{static_cast<uint8_t*>(out), in, pkt_len, num_pkts,
+                nt_threshold_ > 0 && bytes >= nt_threshold_};
+  if (workers_.empty() || bytes < MIN_PARALLEL_BYTES) {
+    CopyRange(job, 0, num_pkts);
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    job_ = job;
+    busy_.store(workers_.size(), std::memory_order_relaxed);
+    generation_++;
+  }
+
+  start_cv_.notify_all();
+  CopyShare(job, 0);
+
+  // The pool's shares take about as long as this thread's, so the wait is short
+  while (busy_.load(std::memory_order_acquire) > 0) {
+    std::this_thread::yield();
+  }
+}
+
+};  // namespace holoscan::ops
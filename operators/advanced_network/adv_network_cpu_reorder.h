@@ -0,0 +1,94 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace holoscan::ops {
+
+/**
+ * @brief Reorders batches of packets into contiguous host memory on a pool of threads
+ *
+ * CPU counterpart of simple_packet_reorder for hosts without a GPU: packet i of a batch is copied
+ * to out + i * pkt_len. Each batch is split into one range of packets per thread, and the calling
+ * thread copies the first range itself. Packets are prefetched a few ahead of the one being copied.
+ * Batches of at least nt_threshold bytes are written with non-temporal stores, so the output does
+ * not evict packets still to be read from the cache.
+ */
+class CpuPacketReorder {
+ public:
+  // Batches smaller than this are copied on the calling thread alone, since waking the pool
+  // would cost more than it saves
+  static constexpr size_t MIN_PARALLEL_BYTES = 256 * 1024;
+  static constexpr size_t DEFAULT_NT_THRESHOLD = 8 * 1024 * 1024;
+
+  /**
+   * @brief Start the thread pool
+   *
+   * @param num_threads Threads copying each batch, including the caller. 1 copies on the caller
+   * @param cpus Cores to pin the pool's threads to, one per thread. Empty leaves them unpinned
+   * @param nt_threshold Smallest batch in bytes written with non-temporal stores. 0 never uses them
+   */
+  explicit CpuPacketReorder(int num_threads, const std::vector<int> &cpus = {},
+                            size_t nt_threshold = DEFAULT_NT_THRESHOLD);
+  ~CpuPacketReorder();
+
+  CpuPacketReorder(const CpuPacketReorder &) = delete;
+  CpuPacketReorder &operator=(const CpuPacketReorder &) = delete;
+
+  /**
+   * @brief Copy a batch of packets into contiguous memory. Returns once the whole batch is copied
+   *
+   * @param out Output buffer of at least pkt_len * num_pkts bytes
+   * @param in Pointer to list of input packet pointers
+   * @param pkt_len Length of each packet. All packets must be the same length
+   * @param num_pkts Number of packets
+   */
+  void Reorder(void *out, const void *const *in, uint16_t pkt_len, uint32_t num_pkts);
+
+  int NumThreads() const { return workers_.size() + 1; }
+
+ private:
+  struct Job {
+    uint8_t *out;
+    const void *const *in;
+    uint16_t pkt_len;
+    uint32_t num_pkts;
+    bool nt;            // Use non-temporal stores
+  };
+
+  void WorkerLoop(int idx);
+  void CopyShare(const Job &job, int idx) const;
+  static void CopyRange(const Job &job, uint32_t first, uint32_t last);
+
+  std::vector<std::thread> workers_;
+  std::mutex mutex_;
+  std::condition_variable start_cv_;
+  Job job_;                     // Batch being copied. Guarded by mutex_
+  uint64_t generation_ = 0;     // Batches handed to the pool so far. Guarded by mutex_
+  bool stop_ = false;           // Guarded by mutex_
+  std::atomic<int> busy_{0};    // Threads of the pool still copying the current batch
+  size_t nt_threshold_;
+};
+
+};  // namespace holoscan::ops
@@ -15,15 +15,22 @@
  * limitations under the License.
  */
 
+#include <algorithm>
 #include <atomic>
 #include <cmath>
 #include <complex>
 #include <chrono>
+#include <cstdio>
+#include <fstream>
 #include <iostream>
 #include <map>
+#include <new>
 #include <set>
+#include <sstream>
+#include <unistd.h>
 
 #include "adv_network_dpdk_mgr.h"
+#include "adv_network_pcap.h"
 #include "holoscan/holoscan.hpp"
 
 
@@ -38,22 +45,94 @@ std::atomic<bool> force_quit = false;
 struct TxWorkerParams {
   int port;
   int queue;
+  int lcore;
   uint32_t batch_size;
   struct rte_ring *ring;
   struct rte_mempool *meta_pool;
   struct rte_mempool *burst_pool;
-  struct rte_ether_addr mac_addr;
+
+  // Written only by the worker, and read by the application through GetTxQueueStats()
+  std::atomic<uint64_t> pkts{0};
+  std::atomic<uint64_t> bytes{0};
+  std::atomic<uint64_t> bursts{0};
+};
+
+// Packets from one receive call on their way to the capture core
+struct CaptureRecord {
+  uint64_t tsc;       // When the packets were received
+  uint16_t port;
+  uint16_t num_pkts;
+  struct rte_mbuf *pkts[DpdkMgr::DEFAULT_NUM_RX_BURST];
+};
+
+struct CaptureParams {
+  int lcore;
+  struct rte_ring *ring;
+  struct rte_mempool *pool;               // CaptureRecords
+  PcapngWriter writer;
+  std::array<uint32_t, RTE_MAX_ETHPORTS> if_idx;  // Interface in the file for each port
+  uint64_t base_ns;                       // Wall clock time at base_tsc
+  uint64_t base_tsc;
+  std::atomic<bool> stop{false};
+  std::atomic<uint64_t> pkts{0};
+  std::atomic<uint64_t> missed_pkts{0};   // Received while every record was in use
+};
+
+// Replays a capture file in place of a NIC queue
+struct PcapReplay {
+  PcapFile file;
+  double ticks_per_ns;  // TSC ticks per nanosecond of capture time. 0 replays at full speed
+  bool loop;
+  size_t next = 0;
+  uint64_t start_tsc = 0;
 };
 
 struct RxWorkerParams {
   int port;
   int queue;
+  int lcore;
   uint32_t batch_size;
   struct rte_ring *ring;
   struct rte_mempool *burst_pool;
   struct rte_mempool *meta_pool;
-  uint64_t rx_pkts = 0;
   bool hds;
+  AdvNetOverloadPolicy overload_policy;
+  uint64_t overload_timeout_ticks;
+  uint64_t timeout_ticks;  // Longest a packet waits for its burst to fill. 0 waits indefinitely
+  uint64_t ticks_per_us;
+  struct rte_mempool *pkt_pool;
+  PcapReplay *replay = nullptr;           // Set when packets come from a file instead of the NIC
+  CaptureParams *capture = nullptr;       // Set when received packets are also written to a file
+
+  // Written only by the worker, and read by the application through GetRxQueueStats()
+  std::atomic<uint64_t> pkts{0};
+  std::atomic<uint64_t> bursts{0};
+  std::atomic<uint64_t> timeout_bursts{0};
+  std::atomic<uint64_t> dropped_pkts{0};
+  std::atomic<uint64_t> recycled_bursts{0};
+  std::atomic<uint64_t> stalls{0};
+  std::atomic<uint64_t> stall_ticks{0};
+  std::atomic<uint64_t> bytes{0};
+  std::atomic<uint64_t> fill_latency_hist[ADV_NET_LATENCY_BUCKETS] = {};
+  std::atomic<uint64_t> fill_latency_ticks{0};
+
+  // Poll state, kept between the turns the worker gives this queue
+  AdvNetBurstParams *burst = nullptr;     // Burst being filled
+  uint64_t first_pkt_tsc = 0;             // When the first packet of the burst was received
+  int nb_rx = 0;                          // Packets received but not yet placed in a burst
+  int pending = 0;                        // Index in mbufs of the first of those packets
+  struct rte_mbuf *mbufs[DpdkMgr::DEFAULT_NUM_RX_BURST];
+};
+
+// Queues one worker core polls round-robin
+struct RxCore {
+  int lcore;
+  std::vector<RxWorkerParams *> queues;
+};
+
+struct TxCore {
+  int lcore;
+  std::vector<TxWorkerParams *> queues;
 };
 
 
@@ -61,6 +140,11 @@ struct DPDKQueueConfig {
   struct rte_mempool *pools[DpdkMgr::BUFFER_SPLIT_SEGS];
   struct rte_eth_rxconf rxconf_qsplit;
   union  rte_eth_rxseg  rx_useg[DpdkMgr::BUFFER_SPLIT_SEGS] = {};
+  struct rte_ring *ring = nullptr;            // Bursts from the RX worker to the operator
+  struct rte_mempool *burst_pool = nullptr;   // Packet pointer arrays for RX bursts
+  struct rte_mempool *meta_pool = nullptr;    // AdvNetBurstParams for RX bursts
+  PcapReplay *replay = nullptr;               // Capture file received from instead of the NIC
+  int lcore = -1;                             // Worker core polling the queue. -1 for none
 };
 
 
@@ -107,16 +191,9 @@ void DpdkMgr::Initialize() {
   }
 
   /* Initialize DPDK params */
-  constexpr int max_nargs = 32;
-  constexpr int max_arg_size = 64;
-  char **_argv;
-  _argv = (char**)malloc(sizeof(char*) * max_nargs);
-  for (int i = 0; i < max_nargs; i++) {
-    _argv[i] = (char*)malloc(max_arg_size);
-  }
-
-  int arg = 0;
-  std::string cores = std::to_string(cfg_.common_.master_core_) + ",";
+  eal_args.clear();
+  std::set<int> lcores = {cfg_.common_.master_core_};
+  std::vector<int> cpus;
   std::set<std::string> ifs;
   std::set<std::string> gpu_bdfs;
   std::unordered_map<uint16_t, std::pair<uint16_t, uint16_t>> port_q_num;
@@ -126,9 +203,20 @@ void DpdkMgr::Initialize() {
   for (const auto &rx : cfg_.rx_) {
     ifs.emplace(rx.if_name_);
     for (const auto &q : rx.queues_) {
-      cores += q.common_.cpu_cores_ + ",";
+      if (!ParseCpuList(q.common_.cpu_cores_, cpus)) {
+        HOLOSCAN_LOG_CRITICAL("Invalid cpu_cores \"{}\" on RX queue {}", q.common_.cpu_cores_,
+            q.common_.name_);
+        return;
+      }
+
+      lcores.insert(cpus.begin(), cpus.end());
 
       if (q.common_.gpu_direct_) {
+        if (IsVirtual(rx.if_name_)) {
+          HOLOSCAN_LOG_CRITICAL("GPUDirect is not supported on virtual device {}", rx.if_name_);
+          return;
+        }
+
         char gpu_bdf[32];
         if (cudaDeviceGetPCIBusId(gpu_bdf, sizeof(gpu_bdf), q.common_.gpu_dev_) != cudaSuccess) {
           HOLOSCAN_LOG_CRITICAL("Cannot get GPU BDF for device ID {}", q.common_.gpu_dev_);
@@ -144,9 +232,20 @@ void DpdkMgr::Initialize() {
   for (const auto &tx : cfg_.tx_) {
     ifs.emplace(tx.if_name_);
     for (const auto &q : tx.queues_) {
-      cores += q.common_.cpu_cores_ + ",";
+      if (!ParseCpuList(q.common_.cpu_cores_, cpus)) {
+        HOLOSCAN_LOG_CRITICAL("Invalid cpu_cores \"{}\" on TX queue {}", q.common_.cpu_cores_,
+            q.common_.name_);
+        return;
+      }
+
+      lcores.insert(cpus.begin(), cpus.end());
 
       if (q.common_.gpu_direct_) {
+        if (IsVirtual(tx.if_name_)) {
+          HOLOSCAN_LOG_CRITICAL("GPUDirect is not supported on virtual device {}", tx.if_name_);
+          return;
+        }
+
         char gpu_bdf[32];
         if (cudaDeviceGetPCIBusId(gpu_bdf, sizeof(gpu_bdf), q.common_.gpu_dev_) != cudaSuccess) {
           HOLOSCAN_LOG_CRITICAL("Cannot get GPU BDF for device ID {}", q.common_.gpu_dev_);
@@ -159,7 +258,28 @@ void DpdkMgr::Initialize() {
     }
   }
 
-  cores = cores.substr(0, cores.size()-1);
+  if (!cfg_.common_.capture_file_.empty()) {
+    if (cfg_.common_.capture_core_ < 0) {
+      HOLOSCAN_LOG_CRITICAL("capture_core must be set to write a capture file");
+      return;
+    }
+
+    lcores.insert(cfg_.common_.capture_core_);
+  }
+
+  // Every core any queue may use is given to EAL, written as ranges to keep the argument short
+  std::string cores;
+  for (auto it = lcores.begin(); it != lcores.end();) {
+    const int first = *it;
+    int last = first;
+    while (++it != lcores.end() && *it == last + 1) {
+      last = *it;
+    }
+
+    cores += (cores.empty() ? "" : ",") + std::to_string(first) +
+        (last > first ? "-" + std::to_string(last) : "");
+  }
+
   // Get a unique set of interfaces
   num_ports = ifs.size();
   HOLOSCAN_LOG_INFO("Attempting to use {} ports for high-speed network", num_ports);
@@ -169,32 +289,60 @@ void DpdkMgr::Initialize() {
     return;
   }
 
-  strncpy(_argv[arg++], "adv_net_operator", max_arg_size - 1);
-  strncpy(_argv[arg++], "-l", max_arg_size - 1);
-  strncpy(_argv[arg++], cores.c_str(), max_arg_size - 1);
-  //  strncpy(_argv[arg++], "--log-level=99", max_arg_size - 1);
-  //  strncpy(_argv[arg++], "--log-level=pmd.net.mlx5:8", max_arg_size - 1);
+  eal_args.push_back("adv_net_operator");
+  eal_args.push_back("-l");
+  eal_args.push_back(cores);
+  //  eal_args.push_back("--log-level=99");
+  //  eal_args.push_back("--log-level=pmd.net.mlx5:8");
+  if (cfg_.common_.no_huge_) {
+    eal_args.push_back("--no-huge");
+  }
+
+  if (cfg_.common_.memory_mb_ > 0) {
+    eal_args.push_back("-m");
+    eal_args.push_back(std::to_string(cfg_.common_.memory_mb_));
+  }
+
+  for (const auto &vdev : cfg_.common_.vdevs_) {
+    eal_args.push_back("--vdev");
+    eal_args.push_back(vdev);
+  }
+
+  // With only virtual devices there is no NIC to probe, and nothing is shared with other DPDK
+  // processes, so a TX and an RX instance can run side by side on one host
+  if (std::all_of(ifs.begin(), ifs.end(), [this](const auto &name) { return IsVirtual(name); })) {
+    eal_args.push_back("--no-pci");
+    eal_args.push_back("--in-memory");
+  }
+
   for (const auto &name : ifs) {
-    strncpy(_argv[arg++], "-a", max_arg_size - 1);
-    strncpy(_argv[arg++], name.c_str(), max_arg_size - 1);
-    //  strncpy(_argv[arg++],
-    //  (name + std::string(",txq_inline_max=0,dv_flow_en=1")).c_str(), max_arg_size - 1);
+    if (IsVirtual(name)) {
+      continue;
+    }
+
+    eal_args.push_back("-a");
+    eal_args.push_back(name);
+    //  eal_args.push_back(name + std::string(",txq_inline_max=0,dv_flow_en=1"));
   }
 
   for (const auto &gpu : gpu_bdfs) {
-    strncpy(_argv[arg++], "-a", max_arg_size - 1);
-    strncpy(_argv[arg++], gpu.c_str(), max_arg_size - 1);
+    eal_args.push_back("-a");
+    eal_args.push_back(gpu);
   }
 
-  _argv[arg] = nullptr;
+  // Arguments of any length and number are passed straight through. EAL may keep pointers into
+  // them, such as the program name, so the strings live as long as the manager
+  std::vector<char*> eal_argv;
   std::string dpdk_args = "";
-  for (int ac = 0; ac < arg; ac++) {
-    dpdk_args += std::string(_argv[ac]) + " ";
+  for (auto &a : eal_args) {
+    eal_argv.push_back(a.data());
+    dpdk_args += a + " ";
   }
 
+  eal_argv.push_back(nullptr);
   HOLOSCAN_LOG_INFO("DPDK EAL arguments: {}", dpdk_args);
 
-  ret = rte_eal_init(arg, _argv);
+  ret = rte_eal_init(eal_argv.size() - 1, eal_argv.data());
   if (ret < 0) {
     HOLOSCAN_LOG_CRITICAL("Invalid EAL arguments: {}", rte_errno);
     return;
@@ -278,6 +426,14 @@ void DpdkMgr::Initialize() {
       q.common_.backend_config_ = new DPDKQueueConfig;
       auto q_backend = static_cast<DPDKQueueConfig *>(q.common_.backend_config_);
 
+      // Default queues have no worker
+      if (!rx.empty) {
+        q_backend->lcore = AssignLcore(q.common_, rx.port_id_, AdvNetDirection::RX);
+        if (q_backend->lcore < 0) {
+          return;
+        }
+      }
+
       std::string append = "_P" + std::to_string(rx.port_id_) + "_Q" +
           std::to_string(q.common_.id_);
       auto rx_mbufs = q.common_.num_concurrent_batches_* q.common_.batch_size_;
@@ -336,7 +492,7 @@ void DpdkMgr::Initialize() {
   #pragma GCC diagnostic push
   #pragma GCC diagnostic ignored "-Wdeprecated-declarations"
         q_backend->pools[1] = rte_pktmbuf_pool_create_extbuf(gpu_name.c_str(), rx_mbufs,
-            0, 0, ext_mem.elt_size, rte_socket_id(), &ext_mem, 1);
+            0, 0, ext_mem.elt_size, PortSocket(rx.port_id_), &ext_mem, 1);
   #pragma GCC diagnostic pop
         if (q_backend->pools[1] == NULL) {
           HOLOSCAN_LOG_CRITICAL("Could not create EXT memory mempool");
@@ -349,7 +505,7 @@ void DpdkMgr::Initialize() {
         auto cpu_name = std::string("RX_CPU_POOL") + append;
         q_backend->pools[0] = rte_pktmbuf_pool_create(cpu_name.c_str(),
             rx_mbufs,  MEMPOOL_CACHE_SIZE, 0, q.common_.hds_ + RTE_PKTMBUF_HEADROOM,
-                rte_socket_id());
+                PortSocket(rx.port_id_));
         if (!q_backend->pools[0]) {
           HOLOSCAN_LOG_CRITICAL("Could not create sysmem mempool {} buffer split: {}",
               cpu_name, rte_errno);
@@ -381,11 +537,11 @@ void DpdkMgr::Initialize() {
         local_port_conf[rx.port_id_].rxmode.offloads |=
             RTE_ETH_RX_OFFLOAD_SCATTER | RTE_ETH_RX_OFFLOAD_BUFFER_SPLIT;
       } else {
-        /* Create the mbuf pools. */
+        /* Create the mbuf pools. The NIC writes them, so they are on the port's NUMA node */
         auto pkt_size = q.common_.max_packet_size_ + RTE_PKTMBUF_HEADROOM + MAX_ETH_HDR_SIZE;
         auto name = std::string("RX_CPU_POOL") + append;
         q_backend->pools[0] = rte_pktmbuf_pool_create(name.c_str(),
-            rx_mbufs, MEMPOOL_CACHE_SIZE, 0, pkt_size, rte_socket_id());
+            rx_mbufs, MEMPOOL_CACHE_SIZE, 0, pkt_size, PortSocket(rx.port_id_));
         if (q_backend->pools[0] == NULL) {
           HOLOSCAN_LOG_CRITICAL("Cannot init mbuf pool");
           return;
@@ -399,53 +555,27 @@ void DpdkMgr::Initialize() {
     local_port_conf[rx.port_id_].rxmode.offloads |= RTE_ETH_RX_OFFLOAD_CHECKSUM;
     local_port_conf[rx.port_id_].rxmode.mtu = max_pkt_size;
     local_port_conf[rx.port_id_].rxmode.max_lro_pkt_size = max_pkt_size;
-  }
 
-  HOLOSCAN_LOG_INFO("Setting up RX ring");
-  rx_ring = rte_ring_create("RX_RING", 2048, rte_socket_id(),
-      RING_F_MC_RTS_DEQ | RING_F_MP_RTS_ENQ);
-  if (rx_ring == nullptr) {
-    HOLOSCAN_LOG_CRITICAL("Failed to allocate ring!");
-    return;
-  }
+    // Default queues have no worker, so they need nothing to pass bursts on
+    if (rx.empty) {
+      continue;
+    }
 
-  auto num_rx_ptrs_bufs = (1UL << 12) - 1;
-  HOLOSCAN_LOG_INFO("Setting up RX burst pool with {} batches",  num_rx_ptrs_bufs);
-  rx_burst_buffer = rte_mempool_create("RX_BURST_POOL",
-                    num_rx_ptrs_bufs,
-                    sizeof(void *) * max_batch_size * 2,  // 2 If HDR is enabled
-                    0,
-                    0,
-                    nullptr,
-                    nullptr,
-                    nullptr,
-                    nullptr,
-                    rte_socket_id(),
-                    0);
-  if (rx_burst_buffer == nullptr) {
-    HOLOSCAN_LOG_CRITICAL("Failed to allocate RX burst pool!");
-    return;
+    for (auto &q : rx.queues_) {
+      if (!CreateRxBurstQueue(rx.port_id_, q)) {
+        return;
+      }
+
+      if (!q.replay_file_.empty() && !CreateReplay(rx.port_id_, q)) {
+        return;
+      }
+    }
   }
 
-  HOLOSCAN_LOG_INFO("Setting up RX meta pool");
-  rx_meta = rte_mempool_create("RX_META_POOL",
-                    (1U << 6) - 1U,
-                    sizeof(AdvNetBurstParams),
-                    0,
-                    0,
-                    nullptr,
-                    nullptr,
-                    nullptr,
-                    nullptr,
-                    rte_socket_id(),
-                    0);
-  if (rx_meta == nullptr) {
-    HOLOSCAN_LOG_CRITICAL("Failed to allocate RX meta pool!");
+  if (!cfg_.common_.capture_file_.empty() && !CreateCapture()) {
     return;
   }
 
-  // For now make a single queue. Support more sophisticated TX on next release
-  max_batch_size = 0;
   for (auto &tx : cfg_.tx_) {
     ret = rte_eth_dev_get_port_by_name(tx.if_name_.c_str(), &tx.port_id_);
     if (ret < 0) {
@@ -454,12 +584,6 @@ void DpdkMgr::Initialize() {
     }
 
     for (auto &q : tx.queues_) {
-      ret = rte_eth_dev_get_port_by_name(tx.if_name_.c_str(), &portid);
-      if (ret < 0) {
-        HOLOSCAN_LOG_CRITICAL("Failed to get port number for {}", tx.if_name_);
-        return;
-      }
-
       if (q.common_.gpu_direct_ && q.common_.hds_ > 0) {
         HOLOSCAN_LOG_CRITICAL("Header data split not supported on TX yet");
         return;
@@ -468,73 +592,57 @@ void DpdkMgr::Initialize() {
       q.common_.backend_config_ = new DPDKQueueConfig;
       auto q_backend = static_cast<DPDKQueueConfig *>(q.common_.backend_config_);
 
-      max_batch_size = std::max(max_batch_size, q.common_.batch_size_);
-      auto tx_mbufs = q.common_.num_concurrent_batches_* q.common_.batch_size_;
-      auto pkt_size = q.common_.max_packet_size_ + RTE_PKTMBUF_HEADROOM;
-      q_backend->pools[0] = rte_pktmbuf_pool_create("TX_POOL",
-          tx_mbufs, MEMPOOL_CACHE_SIZE, 0, pkt_size, rte_socket_id());
-      if (q_backend->pools[0] == NULL) {
-        HOLOSCAN_LOG_CRITICAL("Cannot init TX mbuf pool");
-        return;
+      // Default queues have no worker, so they need nothing to send from
+      if (tx.empty) {
+        continue;
       }
 
-      HOLOSCAN_LOG_INFO("Created TX pool with packet size {} bytes and {} mbufs",
-            pkt_size, tx_mbufs);
+      q_backend->lcore = AssignLcore(q.common_, tx.port_id_, AdvNetDirection::TX);
+      if (q_backend->lcore < 0 || !CreateTxQueue(tx.port_id_, q)) {
+        return;
+      }
     }
 
     local_port_conf[tx.port_id_].txmode.mq_mode  =  RTE_ETH_MQ_TX_NONE;
+    // Multi-segment packets carry payloads attached by adv_net_attach_udp_burst
     local_port_conf[tx.port_id_].txmode.offloads =  RTE_ETH_TX_OFFLOAD_IPV4_CKSUM  |
                                                     RTE_ETH_TX_OFFLOAD_UDP_CKSUM   |
-                                                    RTE_ETH_TX_OFFLOAD_TCP_CKSUM;
-    // Add multi-seg offload when TX GPUDirect is supported
-  }
-
-  HOLOSCAN_LOG_INFO("Setting up TX ring");
-  tx_ring = rte_ring_create("TX_RING", 2048, rte_socket_id(),
-        RING_F_MC_RTS_DEQ | RING_F_MP_RTS_ENQ);
-  if (tx_ring == nullptr) {
-    HOLOSCAN_LOG_CRITICAL("Failed to allocate ring!");
-    return;
-  }
-
-  HOLOSCAN_LOG_INFO("Setting up TX meta pool");
-  tx_meta = rte_mempool_create("TX_META_POOL",
-                    (1U << 6) - 1U,
-                    sizeof(AdvNetBurstParams),
-                    0,
-                    0,
-                    nullptr,
-                    nullptr,
-                    nullptr,
-                    nullptr,
-                    rte_socket_id(),
-                    0);
-  if (tx_meta == nullptr) {
-    HOLOSCAN_LOG_CRITICAL("Failed to allocate TX meta pool!");
-    return;
-  }
-
-  HOLOSCAN_LOG_INFO("Setting up TX burst pool with {} pointers", max_batch_size);
-  tx_burst_buffer = rte_mempool_create("TX_BURST_POOL",
-                    (1U << 5) - 1U,
-                    sizeof(void *) * max_batch_size * 2,
-                    0,
-                    0,
-                    nullptr,
-                    nullptr,
-                    nullptr,
-                    nullptr,
-                    rte_socket_id(),
-                    0);
-  if (tx_burst_buffer == nullptr) {
-    HOLOSCAN_LOG_CRITICAL("Failed to allocate TX message pool!");
-    return;
+                                                    RTE_ETH_TX_OFFLOAD_TCP_CKSUM   |
+                                                    RTE_ETH_TX_OFFLOAD_MULTI_SEGS;
   }
 
   for (const auto &[port, queues] : port_q_num) {
     HOLOSCAN_LOG_INFO("Initializing port {} with {} RX queues and {} TX queues...",
         port, queues.first, queues.second);
 
+    struct rte_eth_dev_info port_info;
+    ret = rte_eth_dev_info_get(port, &port_info);
+    if (ret != 0) {
+      HOLOSCAN_LOG_CRITICAL("Failed to get device info for port {}", port);
+      return;
+    }
+
+    // TX offloads the device lacks are done in software by the TX operator instead
+    auto &conf = local_port_conf[port];
+    if ((conf.txmode.offloads & ~port_info.tx_offload_capa) != 0) {
+      HOLOSCAN_LOG_WARN("Port {} lacks TX offloads {:#x}; checksums are computed in software",
+          port, conf.txmode.offloads & ~port_info.tx_offload_capa);
+      conf.txmode.offloads &= port_info.tx_offload_capa;
+    }
+
+    tx_offloads[port] = conf.txmode.offloads;
+
+    if (IsVirtual(port_id_to_name[port])) {
+      // Virtual devices have no RSS or hardware offloads, so only ask for what the driver has
+      conf.rxmode.mq_mode = RTE_ETH_MQ_RX_NONE;
+      conf.rx_adv_conf.rss_conf.rss_hf = 0;
+      conf.rxmode.offloads &= port_info.rx_offload_capa;
+      conf.rxmode.mtu = std::min<uint32_t>(conf.rxmode.mtu,
+                                           port_info.max_rx_pktlen - MAX_ETH_HDR_SIZE);
+      HOLOSCAN_LOG_INFO("Port {} is virtual device {} using driver {}", port,
+                        port_id_to_name[port], port_info.driver_name);
+    }
+
     ret = rte_eth_dev_configure(port, queues.first, queues.second, &local_port_conf[port]);
     if (ret < 0) {
       HOLOSCAN_LOG_CRITICAL("Cannot configure device: err={}, str={}, port={}",
@@ -559,7 +667,7 @@ void DpdkMgr::Initialize() {
         continue;
       }
 
-      if (rx.flow_isolation_) {
+      if (rx.flow_isolation_ && !IsVirtual(rx.if_name_)) {
         struct rte_flow_error error;
         ret = rte_flow_isolate(rx.port_id_, 1, &error);
         if (ret < 0) {
@@ -568,9 +676,10 @@ void DpdkMgr::Initialize() {
       }
 
       for (const auto &q : rx.queues_) {
-        // Assume one core for now
-        auto socketid = rte_lcore_to_socket_id(strtol(q.common_.cpu_cores_.c_str(), nullptr, 10));
+        // Descriptors go with the worker polling the queue. Default queues have none.
         auto qinfo    = static_cast<DPDKQueueConfig *>(q.common_.backend_config_);
+        auto socketid = qinfo->lcore >= 0 ? static_cast<int>(rte_lcore_to_socket_id(qinfo->lcore)) :
+                                            PortSocket(rx.port_id_);
 
         if (q.common_.gpu_direct_ && q.common_.hds_ > 0) {
           ret = rte_eth_rx_queue_setup(rx.port_id_, q.common_.id_,
@@ -648,6 +757,15 @@ void DpdkMgr::Initialize() {
 
   int flow_num = 0;
   for (const auto &rx : cfg_.rx_) {
+    if (IsVirtual(rx.if_name_)) {
+      if (!rx.flows_.empty()) {
+        HOLOSCAN_LOG_WARN("Virtual device {} has no flow engine; skipping {} flow rules",
+                          rx.if_name_, rx.flows_.size());
+      }
+
+      continue;
+    }
+
     for (const auto &flow : rx.flows_) {
       HOLOSCAN_LOG_INFO("Adding RX flow {}", flow.name_);
       AddFlow(rx.port_id_, flow);
@@ -735,10 +853,351 @@ struct rte_flow *DpdkMgr::AddFlow(int port, const FlowConfig &cfg) {
   return nullptr;
 }
 
-int DpdkMgr::GetRxPkts(void **pkts, int num) {
-  return rte_ring_dequeue_bulk(rx_ring, pkts, num, nullptr);
+bool DpdkMgr::CreateTxQueue(uint16_t port, TxQueueConfig &q) {
+  if (port >= MAX_INTERFACES || q.common_.id_ >= MAX_NUM_TX_QUEUES) {
+    HOLOSCAN_LOG_CRITICAL("TX port {} queue {} is out of range", port, q.common_.id_);
+    return false;
+  }
+
+  // Like RX, each queue has its own ring and pools so TX workers never share anything. Operators
+  // may enqueue from several threads, but only the queue's worker dequeues. Every outstanding
+  // batch holds one burst, so the ring can always take all of them. Packets are read by the NIC
+  // and go on the port's NUMA node; the ring and bursts go on the worker's.
+  auto &txq = tx_queues[port][q.common_.id_];
+  const int pkt_socket = PortSocket(port);
+  const int socket = rte_lcore_to_socket_id(
+      static_cast<DPDKQueueConfig *>(q.common_.backend_config_)->lcore);
+  const auto append = "_P" + std::to_string(port) + "_Q" + std::to_string(q.common_.id_);
+  const unsigned num_bursts = q.common_.num_concurrent_batches_;
+  const auto tx_mbufs = num_bursts * q.common_.batch_size_;
+  const auto pkt_size = q.common_.max_packet_size_ + RTE_PKTMBUF_HEADROOM;
+
+  txq.pkt_pool = rte_pktmbuf_pool_create(("TX_POOL" + append).c_str(), tx_mbufs,
+      MEMPOOL_CACHE_SIZE, 0, pkt_size, pkt_socket);
+  if (txq.pkt_pool == nullptr) {
+    HOLOSCAN_LOG_CRITICAL("Cannot init TX mbuf pool for port {} queue {}", port, q.common_.id_);
+    return false;
+  }
+
+  txq.burst_pool = rte_mempool_create(("TX_BURST" + append).c_str(), num_bursts,
+      sizeof(void *) * q.common_.batch_size_, 0, 0, nullptr, nullptr, nullptr, nullptr,
+      socket, 0);
+  txq.meta_pool = rte_mempool_create(("TX_META" + append).c_str(), num_bursts,
+      sizeof(AdvNetBurstParams), 0, 0, nullptr, nullptr, nullptr, nullptr, socket, 0);
+  txq.ring = rte_ring_create(("TX_RING" + append).c_str(), rte_align32pow2(num_bursts + 1),
+      socket, RING_F_SC_DEQ);
+  if (txq.burst_pool == nullptr || txq.meta_pool == nullptr || txq.ring == nullptr) {
+    HOLOSCAN_LOG_CRITICAL("Failed to allocate TX ring or burst pools for port {} queue {}", port,
+        q.common_.id_);
+    return false;
+  }
+
+  HOLOSCAN_LOG_INFO("Created TX queue for port {} queue {} with packet size {} bytes, {} mbufs "
+      "and {} bursts", port, q.common_.id_, pkt_size, tx_mbufs, num_bursts);
+  return true;
 }
 
+bool DpdkMgr::TxChecksumOffload(uint16_t port) const {
+  constexpr uint64_t cksum_offloads = RTE_ETH_TX_OFFLOAD_IPV4_CKSUM | RTE_ETH_TX_OFFLOAD_UDP_CKSUM;
+  return port < MAX_INTERFACES && (tx_offloads[port] & cksum_offloads) == cksum_offloads;
+}
+
+bool DpdkMgr::TxMultiSegOffload(uint16_t port) const {
+  return port < MAX_INTERFACES && (tx_offloads[port] & RTE_ETH_TX_OFFLOAD_MULTI_SEGS) != 0;
+}
+
+const TxQueueConfig *DpdkMgr::GetTxQueueConfig(uint16_t port, uint16_t q) const {
+  for (const auto &tx : cfg_.tx_) {
+    if (tx.port_id_ != port) {
+      continue;
+    }
+
+    for (const auto &txq : tx.queues_) {
+      if (txq.common_.id_ == q) {
+        return &txq;
+      }
+    }
+  }
+
+  return nullptr;
+}
+
+bool DpdkMgr::RegisterTxMemory(void *addr, size_t len) {
+  // Attached payloads are given to the NIC by virtual address, so that must be the IOVA too
+  if (rte_eal_iova_mode() != RTE_IOVA_VA) {
+    HOLOSCAN_LOG_CRITICAL("TX memory can only be registered when the EAL uses IOVA as VA mode");
+    return false;
+  }
+
+  const size_t page_size = sysconf(_SC_PAGESIZE);
+  int ret = rte_extmem_register(addr, len, NULL, 0, page_size);
+  if (ret != 0) {
+    HOLOSCAN_LOG_CRITICAL("Unable to register TX memory {} of {} bytes: {}", addr, len,
+        rte_strerror(rte_errno));
+    return false;
+  }
+
+  // Virtual devices do no DMA, so only physical ports need the memory mapped
+  for (const auto &tx : cfg_.tx_) {
+    if (IsVirtual(tx.if_name_)) {
+      continue;
+    }
+
+    struct rte_eth_dev_info dev_info;
+    ret = rte_eth_dev_info_get(tx.port_id_, &dev_info);
+    if (ret != 0) {
+      HOLOSCAN_LOG_CRITICAL("Failed to get device info for port {}", tx.port_id_);
+      return false;
+    }
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+    ret = rte_dev_dma_map(dev_info.device, addr, reinterpret_cast<uintptr_t>(addr), len);
+#pragma GCC diagnostic pop
+    if (ret != 0) {
+      HOLOSCAN_LOG_CRITICAL("Could not DMA map TX memory for port {}: err={}", tx.port_id_,
+          rte_errno);
+      return false;
+    }
+  }
+
+  return true;
+}
+
+const DpdkMgr::TxQueue *DpdkMgr::GetTxQueue(uint16_t port, uint16_t q) const {
+  if (port >= MAX_INTERFACES || q >= MAX_NUM_TX_QUEUES || tx_queues[port][q].ring == nullptr) {
+    return nullptr;
+  }
+
+  return &tx_queues[port][q];
+}
+
+bool DpdkMgr::CreateReplay(uint16_t port, RxQueueConfig &q) {
+  if (q.common_.hds_ > 0) {
+    HOLOSCAN_LOG_CRITICAL("Replay is not supported with header-data split on port {} queue {}",
+        port, q.common_.id_);
+    return false;
+  }
+
+  auto replay = new PcapReplay;
+  if (!replay->file.Load(q.replay_file_)) {
+    HOLOSCAN_LOG_CRITICAL("Failed to load replay file for port {} queue {}", port, q.common_.id_);
+    delete replay;
+    return false;
+  }
+
+  replay->ticks_per_ns = q.replay_speed_ > 0 ? rte_get_tsc_hz() / 1e9 / q.replay_speed_ : 0;
+  replay->loop = q.replay_loop_;
+  static_cast<DPDKQueueConfig *>(q.common_.backend_config_)->replay = replay;
+
+  HOLOSCAN_LOG_INFO("Port {} queue {} replays {} {}", port, q.common_.id_, q.replay_file_,
+      q.replay_speed_ > 0 ? fmt::format("at {}x the captured rate", q.replay_speed_) :
+                            std::string("at full speed"));
+  return true;
+}
+
+bool DpdkMgr::CreateCapture() {
+  // Each receive call takes one record, and the ring holds every record, so RX workers never
+  // wait on the capture core. If it falls behind, packets go on downstream but are not written.
+  static constexpr unsigned CAPTURE_RECORDS = 1023;
+
+  capture = new CaptureParams;
+  capture->lcore = cfg_.common_.capture_core_;
+  const int socket = rte_lcore_to_socket_id(capture->lcore);
+  capture->pool = rte_mempool_create("CAPTURE_POOL", CAPTURE_RECORDS, sizeof(CaptureRecord), 0, 0,
+      nullptr, nullptr, nullptr, nullptr, socket, 0);
+  capture->ring = rte_ring_create("CAPTURE_RING", CAPTURE_RECORDS + 1, socket, RING_F_SC_DEQ);
+  if (capture->pool == nullptr || capture->ring == nullptr) {
+    HOLOSCAN_LOG_CRITICAL("Failed to allocate capture ring or record pool");
+    return false;
+  }
+
+  std::vector<std::string> if_names;
+  for (const auto &rx : cfg_.rx_) {
+    if (rx.empty) {
+      continue;
+    }
+
+    capture->if_idx[rx.port_id_] = if_names.size();
+    if_names.push_back(rx.if_name_);
+  }
+
+  if (!capture->writer.Open(cfg_.common_.capture_file_, if_names)) {
+    HOLOSCAN_LOG_CRITICAL("Failed to create capture file {}", cfg_.common_.capture_file_);
+    return false;
+  }
+
+  capture->base_tsc = rte_get_tsc_cycles();
+  capture->base_ns  = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::system_clock::now().time_since_epoch()).count();
+
+  HOLOSCAN_LOG_INFO("Capturing received packets to {} on core {}", cfg_.common_.capture_file_,
+      capture->lcore);
+  return true;
+}
+
+void DpdkMgr::StopCapture() {
+  if (capture == nullptr || capture->stop.load()) {
+    return;
+  }
+
+  capture->stop.store(true);
+  rte_eal_wait_lcore(capture->lcore);
+}
+
+std::string DpdkMgr::RxRingName(uint16_t port, int q) {
+  return "RX_RING_P" + std::to_string(port) + "_Q" + std::to_string(q);
+}
+
+bool DpdkMgr::CreateRxBurstQueue(uint16_t port, RxQueueConfig &q) {
+  // Each queue has its own single-producer, single-consumer ring and burst pools, so RX workers
+  // never contend with each other and the operator dequeues without atomics. Every outstanding
+  // batch holds one burst, so the pools are sized by num_concurrent_batches and the ring can
+  // always take all of them. The worker fills the bursts, so they go on its NUMA node.
+  auto q_backend = static_cast<DPDKQueueConfig *>(q.common_.backend_config_);
+  const int socket = rte_lcore_to_socket_id(q_backend->lcore);
+  const auto append = "_P" + std::to_string(port) + "_Q" + std::to_string(q.common_.id_);
+  const unsigned num_bursts = q.common_.num_concurrent_batches_;
+
+  // Under drop_oldest the worker also dequeues, to take back the oldest burst
+  const unsigned ring_flags = q.overload_policy_ == AdvNetOverloadPolicy::DROP_OLDEST ?
+      RING_F_SP_ENQ : RING_F_SP_ENQ | RING_F_SC_DEQ;
+  q_backend->ring = rte_ring_create(RxRingName(port, q.common_.id_).c_str(),
+      rte_align32pow2(num_bursts + 1), socket, ring_flags);
+  if (q_backend->ring == nullptr) {
+    HOLOSCAN_LOG_CRITICAL("Failed to allocate RX ring for port {} queue {}", port,
+        q.common_.id_);
+    return false;
+  }
+
+  // Pointer arrays hold the CPU packets, and a second one the GPU packets with header-data split
+  const unsigned num_ptr_bufs = num_bursts * (q.common_.hds_ > 0 ? 2 : 1);
+  q_backend->burst_pool = rte_mempool_create(("RX_BURST" + append).c_str(), num_ptr_bufs,
+      sizeof(void *) * q.common_.batch_size_, 0, 0, nullptr, nullptr, nullptr, nullptr,
+      socket, 0);
+  if (q_backend->burst_pool == nullptr) {
+    HOLOSCAN_LOG_CRITICAL("Failed to allocate RX burst pool for port {} queue {}", port,
+        q.common_.id_);
+    return false;
+  }
+
+  q_backend->meta_pool = rte_mempool_create(("RX_META" + append).c_str(), num_bursts,
+      sizeof(AdvNetBurstParams) + RX_META_CTRL_SIZE, 0, 0, nullptr, nullptr, nullptr, nullptr,
+      socket, 0);
+  if (q_backend->meta_pool == nullptr) {
+    HOLOSCAN_LOG_CRITICAL("Failed to allocate RX meta pool for port {} queue {}", port,
+        q.common_.id_);
+    return false;
+  }
+
+  HOLOSCAN_LOG_INFO("Created RX ring and burst pools for port {} queue {} with {} bursts", port,
+      q.common_.id_, num_bursts);
+  return true;
+}
+
+bool DpdkMgr::IsVirtual(const std::string &if_name) const {
+  // Virtual devices are named by the part of their --vdev argument before any options
+  for (const auto &vdev : cfg_.common_.vdevs_) {
+    if (vdev.substr(0, vdev.find(',')) == if_name) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+bool DpdkMgr::ParseCpuList(const std::string &list, std::vector<int> &cpus) {
+  // A comma-separated list of cores and inclusive ranges, such as "1,3-5"
+  cpus.clear();
+  std::stringstream ss(list);
+  std::string item;
+  while (std::getline(ss, item, ',')) {
+    const char *start = item.c_str();
+    char *end;
+    const long first = strtol(start, &end, 10);
+    long last = first;
+    if (end == start) {
+      return false;
+    }
+
+    if (*end == '-') {
+      start = end + 1;
+      last = strtol(start, &end, 10);
+      if (end == start) {
+        return false;
+      }
+    }
+
+    while (isspace(*end)) {
+      end++;
+    }
+
+    if (*end != '\0' || first < 0 || last < first || last >= RTE_MAX_LCORE) {
+      return false;
+    }
+
+    for (long cpu = first; cpu <= last; cpu++) {
+      if (std::find(cpus.begin(), cpus.end(), cpu) == cpus.end()) {
+        cpus.push_back(cpu);
+      }
+    }
+  }
+
+  return !cpus.empty();
+}
+
+int DpdkMgr::PortSocket(uint16_t port) {
+  // Virtual devices, and NICs on systems without NUMA, have no node
+  const int socket = rte_eth_dev_socket_id(port);
+  return socket >= 0 ? socket : SOCKET_ID_ANY;
+}
+
+int DpdkMgr::AssignLcore(const CommonQueueConfig &q, uint16_t port, AdvNetDirection dir) {
+  // A queue is polled by exactly one core. Of the cores it lists, it goes to the one polling the
+  // fewest queues so far, so queues listing the same cores are spread evenly over them, and
+  // queues listing a single core share it. A core runs either RX or TX workers, not both.
+  std::vector<int> cpus;
+  ParseCpuList(q.cpu_cores_, cpus);
+  int lcore = -1;
+  for (const int cpu : cpus) {
+    if (cpu == cfg_.common_.master_core_ || cpu == cfg_.common_.capture_core_) {
+      continue;
+    }
+
+    const auto it = lcore_dir.find(cpu);
+    if (it != lcore_dir.end() && it->second != dir) {
+      continue;
+    }
+
+    if (lcore < 0 || lcore_num_queues[cpu] < lcore_num_queues[lcore]) {
+      lcore = cpu;
+    }
+  }
+
+  const char *dir_name = dir == AdvNetDirection::RX ? "RX" : "TX";
+  if (lcore < 0) {
+    HOLOSCAN_LOG_CRITICAL("No core in cpu_cores \"{}\" is free for {} port {} queue {}. The master "
+        "core, capture core and cores of the other direction cannot poll queues", q.cpu_cores_,
+        dir_name, port, q.id_);
+    return -1;
+  }
+
+  lcore_num_queues[lcore]++;
+  lcore_dir[lcore] = dir;
+
+  const int lcore_socket = rte_lcore_to_socket_id(lcore);
+  const int port_socket = PortSocket(port);
+  if (port_socket != SOCKET_ID_ANY && lcore_socket != port_socket) {
+    HOLOSCAN_LOG_WARN("{} port {} queue {} is polled from core {} on NUMA node {}, but the port is "
+        "on node {}", dir_name, port, q.id_, lcore, lcore_socket, port_socket);
+  }
+
+  HOLOSCAN_LOG_INFO("{} port {} queue {} is polled by core {} on NUMA node {}", dir_name, port,
+      q.id_, lcore, lcore_socket);
+  return lcore;
+}
+
+
 
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -814,6 +1273,8 @@ void PrintDpdkStats() {
 }
 
 DpdkMgr::~DpdkMgr() {
+  StopTelemetry();
+  StopCapture();
   PrintDpdkStats();
 }
 
@@ -832,45 +1293,110 @@ void DpdkMgr::Run() {
   int (*rx_worker)(void*) = rx_core;
   int (*tx_worker)(void*) = tx_core;
 
+  // The capture core starts first so it is ready for the first packets
+  if (capture != nullptr) {
+    rte_eal_remote_launch(capture_core, (void*)capture, capture->lcore);
+  }
+
+  // Queues on the same core are polled by one worker. Worker state is allocated on the worker's
+  // NUMA node, since it is written on every poll.
+  std::map<int, RxCore *> rx_lcore_cores;
   for (auto &rx : cfg_.rx_) {
     if (rx.empty) {
       continue;
     }
     for (auto &q : rx.queues_) {
       auto qinfo = static_cast<DPDKQueueConfig *>(q.common_.backend_config_);
-      auto params = new RxWorkerParams;
+      void *mem = rte_zmalloc_socket("RX_WORKER", sizeof(RxWorkerParams), RTE_CACHE_LINE_SIZE,
+          rte_lcore_to_socket_id(qinfo->lcore));
+      if (mem == nullptr) {
+        HOLOSCAN_LOG_CRITICAL("Failed to allocate RX worker for port {} queue {}", rx.port_id_,
+            q.common_.id_);
+        return;
+      }
+
+      auto params = new (mem) RxWorkerParams;
       params->hds    = q.common_.hds_ > 0;
       params->port   = rx.port_id_;
-      params->ring   = rx_ring;
+      params->ring   = qinfo->ring;
       params->queue  = q.common_.id_;
-      params->burst_pool   = rx_burst_buffer;
-      params->meta_pool  = rx_meta;
+      params->lcore  = qinfo->lcore;
+      params->burst_pool   = qinfo->burst_pool;
+      params->meta_pool  = qinfo->meta_pool;
       params->batch_size = q.common_.batch_size_;
-      rte_eal_remote_launch(rx_worker, (void*)params,
-          strtol(q.common_.cpu_cores_.c_str(), NULL, 10));
+      params->overload_policy = q.overload_policy_;
+      params->overload_timeout_ticks = rte_get_tsc_hz() * q.overload_timeout_us_ / 1000000;
+      params->timeout_ticks = rte_get_tsc_hz() * q.timeout_us_ / 1000000;
+      params->ticks_per_us = std::max<uint64_t>(rte_get_tsc_hz() / 1000000, 1);
+      params->pkt_pool = qinfo->pools[0];
+      params->replay = qinfo->replay;
+      params->capture = capture;
+      rx_workers.push_back(params);
+
+      auto &core = rx_lcore_cores[params->lcore];
+      if (core == nullptr) {
+        core = new RxCore{params->lcore, {}};
+        rx_cores.push_back(core);
+      }
+
+      core->queues.push_back(params);
     }
   }
 
+  std::map<int, TxCore *> tx_lcore_cores;
   for (auto &tx : cfg_.tx_) {
     if (tx.empty) {
       continue;
     }
     for (auto &q : tx.queues_) {
       auto qinfo = static_cast<DPDKQueueConfig *>(q.common_.backend_config_);
-      auto params = new TxWorkerParams;
+      void *mem = rte_zmalloc_socket("TX_WORKER", sizeof(TxWorkerParams), RTE_CACHE_LINE_SIZE,
+          rte_lcore_to_socket_id(qinfo->lcore));
+      if (mem == nullptr) {
+        HOLOSCAN_LOG_CRITICAL("Failed to allocate TX worker for port {} queue {}", tx.port_id_,
+            q.common_.id_);
+        return;
+      }
+
+      auto params = new (mem) TxWorkerParams;
       //  params->hds    = q.common_.hds_ > 0;
       params->port   = tx.port_id_;
-      params->ring   = tx_ring;
+      params->ring   = tx_queues[tx.port_id_][q.common_.id_].ring;
       params->queue  = q.common_.id_;
-      params->burst_pool  = tx_burst_buffer;
-      params->meta_pool   = tx_meta;
+      params->lcore  = qinfo->lcore;
+      params->burst_pool  = tx_queues[tx.port_id_][q.common_.id_].burst_pool;
+      params->meta_pool   = tx_queues[tx.port_id_][q.common_.id_].meta_pool;
       params->batch_size  = q.common_.batch_size_;
-      rte_eth_macaddr_get(tx.port_id_, &params->mac_addr);
-      rte_eal_remote_launch(tx_worker, (void*)params,
-          strtol(q.common_.cpu_cores_.c_str(), NULL, 10));
+      tx_workers.push_back(params);
+
+      auto &core = tx_lcore_cores[params->lcore];
+      if (core == nullptr) {
+        core = new TxCore{params->lcore, {}};
+        tx_cores.push_back(core);
+      }
+
+      core->queues.push_back(params);
     }
   }
 
+  for (auto core : rx_cores) {
+    if (rte_eal_remote_launch(rx_worker, (void*)core, core->lcore) != 0) {
+      HOLOSCAN_LOG_CRITICAL("Failed to launch RX worker on core {}", core->lcore);
+      return;
+    }
+  }
+
+  for (auto core : tx_cores) {
+    if (rte_eal_remote_launch(tx_worker, (void*)core, core->lcore) != 0) {
+      HOLOSCAN_LOG_CRITICAL("Failed to launch TX worker on core {}", core->lcore);
+      return;
+    }
+  }
+
+  if (cfg_.common_.telemetry_interval_ms_ > 0) {
+    telemetry_thread = std::thread(&DpdkMgr::TelemetryLoop, this);
+  }
+
   HOLOSCAN_LOG_INFO("Done starting workers");
 }
 
@@ -878,14 +1404,22 @@ void DpdkMgr::wait() {
   int icore = 0;
 
   HOLOSCAN_LOG_INFO("Stopping all workers");
+  StopTelemetry();
   force_quit.store(true);
   RTE_LCORE_FOREACH_WORKER(icore) {
+    // The capture core keeps running until the workers have stopped queueing packets to it
+    if (capture != nullptr && icore == capture->lcore) {
+      continue;
+    }
+
     if (rte_eal_wait_lcore(icore) < 0) {
       fprintf(stderr, "bad exit for coreid: %d\n", icore);
       break;
     }
   }
 
+  // Every RX worker has exited, so the capture core writes out all it was given before stopping
+  StopCapture();
   PrintDpdkStats();
 }
 
@@ -902,171 +1436,595 @@ void DpdkMgr::flush_packets(int port) {
   }
 }
 
-void DpdkMgr::check_pkts_to_free(rte_ring *msg_ring,
-    rte_mempool *burst_pool, rte_mempool *meta_pool) {
-    AdvNetBurstParams *msg;
-    if (rte_ring_dequeue(msg_ring, reinterpret_cast<void**>(&msg)) == 0) {
-      for (int p = 0; p < msg->hdr.num_pkts; p++) {
-        rte_pktmbuf_free_seg(reinterpret_cast<rte_mbuf*>(msg->cpu_pkts[p]));
-      }
-      rte_mempool_put(burst_pool, msg->cpu_pkts);
-      rte_mempool_put(meta_pool, msg);
+std::vector<AdvNetRxQueueStats> DpdkMgr::GetRxQueueStats() const {
+  std::vector<AdvNetRxQueueStats> stats;
+  const double ns_per_tick = 1e9 / rte_get_tsc_hz();
+  for (const auto params : rx_workers) {
+    AdvNetRxQueueStats q;
+    q.port_id         = params->port;
+    q.q_id            = params->queue;
+    q.pkts            = params->pkts.load(std::memory_order_relaxed);
+    q.bursts          = params->bursts.load(std::memory_order_relaxed);
+    q.timeout_bursts  = params->timeout_bursts.load(std::memory_order_relaxed);
+    q.dropped_pkts    = params->dropped_pkts.load(std::memory_order_relaxed);
+    q.recycled_bursts = params->recycled_bursts.load(std::memory_order_relaxed);
+    q.stalls          = params->stalls.load(std::memory_order_relaxed);
+    q.stall_ns        = params->stall_ticks.load(std::memory_order_relaxed) * ns_per_tick;
+    q.bytes           = params->bytes.load(std::memory_order_relaxed);
+    q.ring_bursts     = rte_ring_count(params->ring);
+    q.free_bursts     = rte_mempool_avail_count(params->meta_pool);
+    for (uint32_t b = 0; b < ADV_NET_LATENCY_BUCKETS; b++) {
+      q.fill_latency_hist[b] = params->fill_latency_hist[b].load(std::memory_order_relaxed);
     }
+    q.fill_latency_ns = params->fill_latency_ticks.load(std::memory_order_relaxed) * ns_per_tick;
+    stats.push_back(q);
+  }
+
+  return stats;
 }
 
-////////////////////////////////////////////////////////////////////////////////
-///
-///  \brief
-///
-////////////////////////////////////////////////////////////////////////////////
-int DpdkMgr::rx_core(void *arg) {
-  RxWorkerParams *tparams = (RxWorkerParams*)arg;
-  struct rte_mbuf * rx_mbufs[DEFAULT_NUM_RX_BURST];
-  int ret = 0;
+std::vector<AdvNetTxQueueStats> DpdkMgr::GetTxQueueStats() const {
+  std::vector<AdvNetTxQueueStats> stats;
+  for (const auto params : tx_workers) {
+    AdvNetTxQueueStats q;
+    q.port_id     = params->port;
+    q.q_id        = params->queue;
+    q.pkts        = params->pkts.load(std::memory_order_relaxed);
+    q.bytes       = params->bytes.load(std::memory_order_relaxed);
+    q.bursts      = params->bursts.load(std::memory_order_relaxed);
+    q.ring_bursts = rte_ring_count(params->ring);
+    q.free_bursts = rte_mempool_avail_count(params->meta_pool);
+    q.free_pkts   = rte_mempool_avail_count(tx_queues[params->port][params->queue].pkt_pool);
+    stats.push_back(q);
+  }
+
+  return stats;
+}
 
-  uint64_t freq = rte_get_tsc_hz();
-  uint64_t timeout_ticks = freq * 0.02;  // expect all packets within 20ms
+std::vector<AdvNetPortStats> DpdkMgr::GetPortStats() const {
+  std::vector<AdvNetPortStats> stats;
+  uint16_t port;
+  RTE_ETH_FOREACH_DEV(port) {
+    struct rte_eth_stats eth_stats;
+    if (rte_eth_stats_get(port, &eth_stats) != 0) {
+      continue;
+    }
 
-  uint64_t total_pkts = 0;
+    AdvNetPortStats p;
+    p.port_id   = port;
+    p.rx_pkts   = eth_stats.ipackets;
+    p.tx_pkts   = eth_stats.opackets;
+    p.rx_bytes  = eth_stats.ibytes;
+    p.tx_bytes  = eth_stats.obytes;
+    p.rx_missed = eth_stats.imissed;
+    p.rx_errors = eth_stats.ierrors;
+    p.tx_errors = eth_stats.oerrors;
+    p.rx_nombuf = eth_stats.rx_nombuf;
+    stats.push_back(p);
+  }
 
-  flush_packets(tparams->port);
-  struct rte_mbuf* mbuf_arr[DEFAULT_NUM_RX_BURST];
+  return stats;
+}
 
-  HOLOSCAN_LOG_INFO("Starting RX Core {}, port {}, queue {}, socket {}",
-      rte_lcore_id(), tparams->port, tparams->queue, rte_socket_id());
-  int nb_rx = 0;
-  int to_copy = 0;
-  //
-  //  run loop
-  //
-  while (!force_quit.load()) {
-    AdvNetBurstParams *burst;
-    if (rte_mempool_get(tparams->meta_pool, reinterpret_cast<void **>(&burst)) < 0) {
-      HOLOSCAN_LOG_ERROR("Processing function falling behind. No free buffers for metadata!");
-      exit(1);
-    }
+AdvNetTelemetry DpdkMgr::GetTelemetry() const {
+  AdvNetTelemetry telemetry;
+  telemetry.timestamp_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::system_clock::now().time_since_epoch()).count();
+  telemetry.ports     = GetPortStats();
+  telemetry.rx_queues = GetRxQueueStats();
+  telemetry.tx_queues = GetTxQueueStats();
+  return telemetry;
+}
+
+void DpdkMgr::TelemetryLoop() {
+  const auto interval = std::chrono::milliseconds(cfg_.common_.telemetry_interval_ms_);
+  auto next = std::chrono::steady_clock::now() + interval;
+  auto prev = GetTelemetry();
+
+  HOLOSCAN_LOG_INFO("Exporting telemetry every {}ms to {}", cfg_.common_.telemetry_interval_ms_,
+      cfg_.common_.telemetry_file_.empty() ? "the log" : cfg_.common_.telemetry_file_);
 
-    if (rte_mempool_get(tparams->burst_pool, reinterpret_cast<void **>(&burst->cpu_pkts)) < 0) {
-      HOLOSCAN_LOG_ERROR("Processing function falling behind. No free CPU buffers for packets!");
+  while (!telemetry_stop.load()) {
+    // Sleep in short steps so a long interval does not hold up shutdown
+    const auto now = std::chrono::steady_clock::now();
+    if (now < next) {
+      std::this_thread::sleep_for(std::min<std::chrono::steady_clock::duration>(
+          next - now, std::chrono::milliseconds(100)));
       continue;
     }
 
-    //  Queue ID for receiver to differentiate
-    burst->hdr.q_id = tparams->queue;
-
-    if (tparams->hds) {
-      if (rte_mempool_get(tparams->burst_pool, reinterpret_cast<void **>(&burst->gpu_pkts)) < 0) {
-        HOLOSCAN_LOG_ERROR("Processing function falling behind. No free GPU buffers for packets!");
-        rte_mempool_put(tparams->burst_pool, burst->cpu_pkts);
-        continue;
-      }
+    next += interval;
+    auto cur = GetTelemetry();
+    if (cfg_.common_.telemetry_file_.empty()) {
+      LogTelemetry(prev, cur);
     } else {
-      burst->gpu_pkts = nullptr;
+      WriteTelemetryFile(cur);
     }
 
-    if (nb_rx > 0) {
-      memcpy(&burst->cpu_pkts[0], &mbuf_arr[to_copy], sizeof(rte_mbuf*) * nb_rx);
-      burst->hdr.num_pkts = nb_rx;
+    prev = std::move(cur);
+  }
+}
 
-      if (tparams->hds) {
-        for (int p = 0; p < nb_rx; p++) {
-          burst->gpu_pkts[p] = mbuf_arr[to_copy + p]->next;
-        }
-      }
+void DpdkMgr::StopTelemetry() {
+  telemetry_stop.store(true);
+  if (telemetry_thread.joinable()) {
+    telemetry_thread.join();
+  }
+}
 
-      nb_rx = 0;
-    } else {
-      burst->hdr.num_pkts = 0;
+void DpdkMgr::LogTelemetry(const AdvNetTelemetry &prev, const AdvNetTelemetry &cur) const {
+  const double secs = (cur.timestamp_ns - prev.timestamp_ns) / 1e9;
+  if (secs <= 0) {
+    return;
+  }
+
+  // Workers are only added at startup, so queues are in the same order in every snapshot
+  for (size_t i = 0; i < cur.rx_queues.size(); i++) {
+    const auto &c = cur.rx_queues[i];
+    const auto &p = prev.rx_queues[i];
+    const auto bursts = c.bursts - p.bursts;
+    HOLOSCAN_LOG_INFO("RX port {} queue {}: {:.0f} packets/s, {:.2f} Gbps, {} dropped, {} bursts "
+        "queued, {} free, {:.1f}us average fill", c.port_id, c.q_id, (c.pkts - p.pkts) / secs,
+        (c.bytes - p.bytes) * 8 / secs / 1e9, c.dropped_pkts - p.dropped_pkts, c.ring_bursts,
+        c.free_bursts, bursts > 0 ? (c.fill_latency_ns - p.fill_latency_ns) / 1e3 / bursts : 0.0);
+  }
+
+  for (size_t i = 0; i < cur.tx_queues.size(); i++) {
+    const auto &c = cur.tx_queues[i];
+    const auto &p = prev.tx_queues[i];
+    HOLOSCAN_LOG_INFO("TX port {} queue {}: {:.0f} packets/s, {:.2f} Gbps, {} bursts queued, "
+        "{} free", c.port_id, c.q_id, (c.pkts - p.pkts) / secs,
+        (c.bytes - p.bytes) * 8 / secs / 1e9, c.ring_bursts, c.free_bursts);
+  }
+
+  for (size_t i = 0; i < cur.ports.size() && i < prev.ports.size(); i++) {
+    const auto &c = cur.ports[i];
+    const auto &p = prev.ports[i];
+    HOLOSCAN_LOG_INFO("Port {}: {} missed, {} no mbuf, {} RX errors, {} TX errors", c.port_id,
+        c.rx_missed - p.rx_missed, c.rx_nombuf - p.rx_nombuf, c.rx_errors - p.rx_errors,
+        c.tx_errors - p.tx_errors);
+  }
+}
+
+void DpdkMgr::WriteTelemetryFile(const AdvNetTelemetry &cur) const {
+  // Write to a temporary file and rename it over the last one, so readers never see it half done
+  const auto &path = cfg_.common_.telemetry_file_;
+  const auto tmp_path = path + ".tmp";
+  {
+    std::ofstream out(tmp_path, std::ios::trunc);
+    if (!out) {
+      HOLOSCAN_LOG_ERROR("Failed to open telemetry file {}", tmp_path);
+      return;
     }
 
-    // DPDK on some ARM platforms requires that you always pass nb_pkts as a number divisible
-    // by 4. If you pass something other than that, you get undefined results and will end up
-    // running out of buffers.
-    do {
-      int burst_size = std::min((uint32_t)DEFAULT_NUM_RX_BURST,
-          (uint32_t)(tparams->batch_size - burst->hdr.num_pkts));
-      nb_rx  = rte_eth_rx_burst(tparams->port, tparams->queue,
-          reinterpret_cast<rte_mbuf**>(&mbuf_arr[0]), DEFAULT_NUM_RX_BURST);
+    out << adv_net_telemetry_to_prometheus(cur);
+  }
 
-      if (nb_rx == 0) {
-        continue;
-      }
+  if (std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+    HOLOSCAN_LOG_ERROR("Failed to move telemetry file to {}", path);
+  }
+}
+
+// Counters have a single writer, so a relaxed load and store is enough to add to them
+static inline void AddCounter(std::atomic<uint64_t> &counter, uint64_t n) {
+  counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+}
+
+static void EnqueueRxBurst(RxWorkerParams *tparams, AdvNetBurstParams *burst,
+    uint64_t first_pkt_tsc, bool timed_out) {
+  // The mbuf headers were just written by the driver, so they are still in cache
+  uint64_t bytes = 0;
+  for (int64_t p = 0; p < burst->hdr.num_pkts; p++) {
+    bytes += reinterpret_cast<rte_mbuf*>(burst->cpu_pkts[p])->pkt_len;
+  }
+
+  // The ring has room for every burst in the pool, so this cannot fail
+  rte_ring_enqueue(tparams->ring, reinterpret_cast<void *>(burst));
+
+  const uint64_t fill_ticks = rte_get_tsc_cycles() - first_pkt_tsc;
+  const uint64_t fill_us = fill_ticks / tparams->ticks_per_us;
+  const uint32_t bucket = fill_us == 0 ? 0 :
+      std::min<uint32_t>(64 - __builtin_clzll(fill_us), ADV_NET_LATENCY_BUCKETS - 1);
+  AddCounter(tparams->fill_latency_hist[bucket], 1);
+  AddCounter(tparams->fill_latency_ticks, fill_ticks);
+  AddCounter(tparams->bytes, bytes);
+  AddCounter(tparams->pkts, burst->hdr.num_pkts);
+  AddCounter(tparams->bursts, 1);
+  if (timed_out) {
+    AddCounter(tparams->timeout_bursts, 1);
+  }
+}
+
+static bool TryGetRxBurst(RxWorkerParams *tparams, AdvNetBurstParams **burst) {
+  if (rte_mempool_get(tparams->meta_pool, reinterpret_cast<void **>(burst)) < 0) {
+    return false;
+  }
+
+  if (rte_mempool_get(tparams->burst_pool, reinterpret_cast<void **>(&(*burst)->cpu_pkts)) < 0) {
+    rte_mempool_put(tparams->meta_pool, *burst);
+    return false;
+  }
+
+  (*burst)->gpu_pkts = nullptr;
+  if (tparams->hds &&
+      rte_mempool_get(tparams->burst_pool, reinterpret_cast<void **>(&(*burst)->gpu_pkts)) < 0) {
+    rte_mempool_put(tparams->burst_pool, (*burst)->cpu_pkts);
+    rte_mempool_put(tparams->meta_pool, *burst);
+    return false;
+  }
+
+  return true;
+}
+
+AdvNetBurstParams *DpdkMgr::GetRxBurst(RxWorkerParams *tparams) {
+  AdvNetBurstParams *burst;
+  if (likely(TryGetRxBurst(tparams, &burst))) {
+    return burst;
+  }
+
+  if (tparams->dropped_pkts.load(std::memory_order_relaxed) == 0 &&
+      tparams->stalls.load(std::memory_order_relaxed) == 0) {
+    HOLOSCAN_LOG_WARN("Processing function falling behind on port {} queue {}. No free burst "
+        "buffers; applying overload policy", tparams->port, tparams->queue);
+  }
 
-      to_copy       = std::min(nb_rx, (int)(tparams->batch_size - burst->hdr.num_pkts));
-      memcpy(&burst->cpu_pkts[burst->hdr.num_pkts], mbuf_arr, sizeof(rte_mbuf*) * to_copy);
-      if (tparams->hds) {
-        for (int p = 0; p < to_copy; p++) {
-          burst->gpu_pkts[burst->hdr.num_pkts + p] = mbuf_arr[p]->next;
+  switch (tparams->overload_policy) {
+    case AdvNetOverloadPolicy::DROP_OLDEST:
+      // The burst keeps its pointer arrays, which belong to this queue, so it is reused as is
+      if (rte_ring_dequeue(tparams->ring, reinterpret_cast<void **>(&burst)) == 0) {
+        adv_net_free_pkts(burst->cpu_pkts, burst->hdr.num_pkts);
+        if (burst->gpu_pkts != nullptr) {
+          adv_net_free_pkts(burst->gpu_pkts, burst->hdr.num_pkts);
         }
+
+        AddCounter(tparams->dropped_pkts, burst->hdr.num_pkts);
+        AddCounter(tparams->recycled_bursts, 1);
+        return burst;
+      }
+
+      // Every burst is downstream, so there is nothing to take back
+      return nullptr;
+    case AdvNetOverloadPolicy::BLOCK: {
+      AddCounter(tparams->stalls, 1);
+      const uint64_t start = rte_get_tsc_cycles();
+      uint64_t waited = 0;
+      bool got = false;
+      while (!got && waited < tparams->overload_timeout_ticks && !force_quit.load()) {
+        rte_pause();
+        got = TryGetRxBurst(tparams, &burst);
+        waited = rte_get_tsc_cycles() - start;
       }
 
-      burst->hdr.num_pkts += to_copy;
-      nb_rx               -= to_copy;
-      total_pkts          += nb_rx;
+      AddCounter(tparams->stall_ticks, waited);
+      return got ? burst : nullptr;
+    }
+    case AdvNetOverloadPolicy::DROP_NEWEST:
+    default:
+      return nullptr;
+  }
+}
+
+int DpdkMgr::check_pkts_to_free(rte_ring *msg_ring,
+    rte_mempool *burst_pool, rte_mempool *meta_pool) {
+  AdvNetBurstParams *msgs[TX_RING_DEQUEUE_SIZE];
+  void *pkt_bufs[TX_RING_DEQUEUE_SIZE];
+  const auto n = rte_ring_dequeue_burst(msg_ring, reinterpret_cast<void**>(msgs),
+      TX_RING_DEQUEUE_SIZE, nullptr);
+  for (unsigned m = 0; m < n; m++) {
+    rte_pktmbuf_free_bulk(reinterpret_cast<rte_mbuf**>(msgs[m]->cpu_pkts), msgs[m]->hdr.num_pkts);
+    pkt_bufs[m] = msgs[m]->cpu_pkts;
+  }
+
+  rte_mempool_put_bulk(burst_pool, pkt_bufs, n);
+  rte_mempool_put_bulk(meta_pool, reinterpret_cast<void**>(msgs), n);
+  return n;
+}
+
+// Allocate packets from a replay file whose time has come, as if they had arrived on the NIC
+static uint16_t ReplayPkts(RxWorkerParams *tparams, rte_mbuf **mbufs, uint16_t n) {
+  auto replay = tparams->replay;
+  const auto &pkts = replay->file.Packets();
+  if (replay->next == pkts.size()) {
+    if (!replay->loop || pkts.empty()) {
+      return 0;
+    }
+
+    replay->next = 0;
+    replay->start_tsc = 0;
+  }
+
+  const uint64_t now = rte_get_tsc_cycles();
+  if (replay->start_tsc == 0) {
+    replay->start_tsc = now;
+  }
 
-      if (burst->hdr.num_pkts == tparams->batch_size) {
-        rte_ring_enqueue(tparams->ring, reinterpret_cast<void *>(burst));
+  // A packet is due once its time after the first packet, scaled by the speed, has passed
+  uint16_t num = 0;
+  while (num < n && replay->next + num < pkts.size()) {
+    if (replay->ticks_per_ns > 0) {
+      const auto ts = pkts[replay->next + num].ts_ns;
+      const uint64_t offset_ns = ts > pkts[0].ts_ns ? ts - pkts[0].ts_ns : 0;
+      if (now - replay->start_tsc < offset_ns * replay->ticks_per_ns) {
         break;
       }
-    } while (!force_quit.load());
+    }
+
+    num++;
+  }
+
+  // With no free mbufs the packets stay due, and go out once the application frees some
+  if (num == 0 || rte_pktmbuf_alloc_bulk(tparams->pkt_pool, mbufs, num) != 0) {
+    return 0;
+  }
+
+  for (uint16_t p = 0; p < num; p++) {
+    const auto &pkt = pkts[replay->next + p];
+    const uint32_t len = std::min<uint32_t>(pkt.len, rte_pktmbuf_tailroom(mbufs[p]));
+    rte_memcpy(rte_pktmbuf_mtod(mbufs[p], void*), replay->file.Data(pkt), len);
+    mbufs[p]->data_len = len;
+    mbufs[p]->pkt_len  = len;
+    mbufs[p]->port     = tparams->port;
+  }
+
+  replay->next += num;
+  return num;
+}
+
+// Pass packets to the capture core as well as downstream. Each segment gets a reference for the
+// capture core, so the application can free packets before they are written.
+static void CapturePkts(RxWorkerParams *tparams, rte_mbuf **mbufs, uint16_t n) {
+  auto capture = tparams->capture;
+  CaptureRecord *rec;
+  if (rte_mempool_get(capture->pool, reinterpret_cast<void **>(&rec)) != 0) {
+    capture->missed_pkts.fetch_add(n, std::memory_order_relaxed);
+    return;
+  }
+
+  rec->tsc = rte_get_tsc_cycles();
+  rec->port = tparams->port;
+  rec->num_pkts = n;
+  for (uint16_t p = 0; p < n; p++) {
+    for (auto seg = mbufs[p]; seg != nullptr; seg = seg->next) {
+      rte_mbuf_refcnt_update(seg, 1);
+    }
+
+    rec->pkts[p] = mbufs[p];
+  }
+
+  // The ring has room for every record in the pool, so this cannot fail
+  rte_ring_enqueue(capture->ring, rec);
+}
+
+static uint16_t ReceivePkts(RxWorkerParams *tparams, rte_mbuf **mbufs, uint16_t n) {
+  const uint16_t nb_rx = tparams->replay != nullptr ? ReplayPkts(tparams, mbufs, n) :
+      rte_eth_rx_burst(tparams->port, tparams->queue, mbufs, n);
+  if (tparams->capture != nullptr && nb_rx > 0) {
+    CapturePkts(tparams, mbufs, nb_rx);
+  }
+
+  return nb_rx;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+///  \brief
+///
+////////////////////////////////////////////////////////////////////////////////
+void DpdkMgr::poll_rx_queue(RxWorkerParams *tparams) {
+  if (tparams->burst == nullptr) {
+    tparams->burst = GetRxBurst(tparams);
+    if (tparams->burst == nullptr) {
+      // There is nowhere to put packets, so anything left over from the last burst and waiting
+      // in the NIC queue is dropped. That keeps the NIC from backing up while downstream stalls.
+      rte_pktmbuf_free_bulk(&tparams->mbufs[tparams->pending], tparams->nb_rx);
+      AddCounter(tparams->dropped_pkts, tparams->nb_rx);
+      tparams->nb_rx = ReceivePkts(tparams, tparams->mbufs, DEFAULT_NUM_RX_BURST);
+      rte_pktmbuf_free_bulk(tparams->mbufs, tparams->nb_rx);
+      AddCounter(tparams->dropped_pkts, tparams->nb_rx);
+      tparams->nb_rx = 0;
+      return;
+    }
+
+    //  Queue ID for receiver to differentiate
+    tparams->burst->hdr.q_id = tparams->queue;
+    tparams->burst->hdr.num_pkts = 0;
+  }
+
+  // Packets left over from the last burst go first. A burst is passed on once it is full, or
+  // once its first packet has waited timeout_us.
+  auto burst = tparams->burst;
+
+  // DPDK on some ARM platforms requires that you always pass nb_pkts as a number divisible
+  // by 4. If you pass something other than that, you get undefined results and will end up
+  // running out of buffers.
+  if (tparams->nb_rx == 0) {
+    tparams->pending = 0;
+    tparams->nb_rx = ReceivePkts(tparams, tparams->mbufs, DEFAULT_NUM_RX_BURST);
+  }
+
+  if (tparams->nb_rx > 0) {
+    if (burst->hdr.num_pkts == 0) {
+      tparams->first_pkt_tsc = rte_get_tsc_cycles();
+    }
+
+    int to_copy = std::min(tparams->nb_rx, (int)(tparams->batch_size - burst->hdr.num_pkts));
+    memcpy(&burst->cpu_pkts[burst->hdr.num_pkts], &tparams->mbufs[tparams->pending],
+        sizeof(rte_mbuf*) * to_copy);
+    if (tparams->hds) {
+      for (int p = 0; p < to_copy; p++) {
+        burst->gpu_pkts[burst->hdr.num_pkts + p] = tparams->mbufs[tparams->pending + p]->next;
+      }
+    }
+
+    burst->hdr.num_pkts += to_copy;
+    tparams->pending    += to_copy;
+    tparams->nb_rx      -= to_copy;
+  }
+
+  if (burst->hdr.num_pkts == tparams->batch_size) {
+    EnqueueRxBurst(tparams, burst, tparams->first_pkt_tsc, false);
+    tparams->burst = nullptr;
+  } else if (tparams->timeout_ticks > 0 && burst->hdr.num_pkts > 0 &&
+             rte_get_tsc_cycles() - tparams->first_pkt_tsc >= tparams->timeout_ticks) {
+    EnqueueRxBurst(tparams, burst, tparams->first_pkt_tsc, true);
+    tparams->burst = nullptr;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+///  \brief
+///
+////////////////////////////////////////////////////////////////////////////////
+int DpdkMgr::rx_core(void *arg) {
+  auto core = static_cast<RxCore*>(arg);
+
+  HOLOSCAN_LOG_INFO("Starting RX Core {}, socket {}, polling {} queue(s)", rte_lcore_id(),
+      rte_socket_id(), core->queues.size());
+  for (auto tparams : core->queues) {
+    HOLOSCAN_LOG_INFO("RX Core {} polls port {}, queue {}", rte_lcore_id(), tparams->port,
+        tparams->queue);
+
+    // A replayed queue never reads from its port, which may be a null device that is never empty
+    if (tparams->replay == nullptr) {
+      flush_packets(tparams->port);
+    }
+  }
+
+  //
+  //  run loop. Each queue gets one receive call in turn, so a quiet queue never holds up the others
+  //
+  while (!force_quit.load()) {
+    for (auto tparams : core->queues) {
+      poll_rx_queue(tparams);
+    }
+  }
+
+  for (auto tparams : core->queues) {
+    HOLOSCAN_LOG_INFO("Total packets received by application (port/queue {}/{}): {}",
+          tparams->port, tparams->queue, tparams->pkts.load());
   }
 
-  HOLOSCAN_LOG_ERROR("Total packets received by application (port/queue {}/{}): {}\n",
-        tparams->port, tparams->queue, total_pkts);
   return 0;
 }
 
+void DpdkMgr::poll_tx_queue(TxWorkerParams *tparams) {
+  AdvNetBurstParams *msgs[TX_RING_DEQUEUE_SIZE];
+  void *pkt_bufs[TX_RING_DEQUEUE_SIZE];
 
+  const auto n = rte_ring_dequeue_burst(tparams->ring, reinterpret_cast<void**>(msgs),
+      TX_RING_DEQUEUE_SIZE, nullptr);
+  if (n == 0) {
+    return;
+  }
 
-int DpdkMgr::tx_core(void *arg) {
-  TxWorkerParams *tparams = (TxWorkerParams*)arg;
-  uint64_t seq;
+  // Headers were filled in by the TX operator, so the packets only need handing to the NIC.
+  // This worker owns the queue, so the only wait is for descriptors the NIC has not finished.
   uint64_t pkts_tx = 0;
-  AdvNetBurstParams *msg;
-  int64_t bursts = 0;
+  uint64_t bytes_tx = 0;
+  for (unsigned m = 0; m < n; m++) {
+    auto pkts = reinterpret_cast<rte_mbuf**>(msgs[m]->cpu_pkts);
+    for (int64_t p = 0; p < msgs[m]->hdr.num_pkts; p++) {
+      bytes_tx += pkts[p]->pkt_len;
+    }
 
-  HOLOSCAN_LOG_INFO("Starting TX Core {}, port {}, queue {} socket {}", rte_lcore_id(),
-        tparams->port, tparams->queue, rte_socket_id());
+    size_t sent = 0;
+    while (sent != msgs[m]->hdr.num_pkts && !force_quit.load()) {
+      auto to_send = static_cast<uint16_t>(
+            std::min(static_cast<size_t>(DEFAULT_NUM_TX_BURST), msgs[m]->hdr.num_pkts - sent));
+      sent += rte_eth_tx_burst(tparams->port, tparams->queue, &pkts[sent], to_send);
+    }
+
+    // Packets the NIC took are freed by the driver once sent. Only a shutdown leaves any.
+    rte_pktmbuf_free_bulk(&pkts[sent], msgs[m]->hdr.num_pkts - sent);
+    pkt_bufs[m] = msgs[m]->cpu_pkts;
+    pkts_tx += sent;
+  }
+
+  rte_mempool_put_bulk(tparams->burst_pool, pkt_bufs, n);
+  rte_mempool_put_bulk(tparams->meta_pool, reinterpret_cast<void**>(msgs), n);
+  AddCounter(tparams->pkts, pkts_tx);
+  AddCounter(tparams->bytes, bytes_tx);
+  AddCounter(tparams->bursts, n);
+}
+
+int DpdkMgr::tx_core(void *arg) {
+  auto core = static_cast<TxCore*>(arg);
+
+  HOLOSCAN_LOG_INFO("Starting TX Core {}, socket {}, serving {} queue(s)", rte_lcore_id(),
+        rte_socket_id(), core->queues.size());
+  for (auto tparams : core->queues) {
+    HOLOSCAN_LOG_INFO("TX Core {} serves port {}, queue {}", rte_lcore_id(), tparams->port,
+        tparams->queue);
+  }
 
   while (!force_quit.load()) {
-    if (rte_ring_dequeue(tparams->ring, reinterpret_cast<void**>(&msg)) != 0) {
-      continue;
+    for (auto tparams : core->queues) {
+      poll_tx_queue(tparams);
     }
+  }
 
-    HOLOSCAN_LOG_DEBUG("Got burst in TX");
+  // Free anything still waiting to be sent
+  for (auto tparams : core->queues) {
+    while (check_pkts_to_free(tparams->ring, tparams->burst_pool, tparams->meta_pool) > 0) {}
 
-    for (size_t p = 0; p < msg->hdr.num_pkts; p++) {
-      auto *mbuf = reinterpret_cast<rte_mbuf*>(msg->cpu_pkts[p]);
-      auto *pkt  = rte_pktmbuf_mtod(mbuf, uint8_t*);
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Waddress-of-packed-member"
-      rte_ether_addr_copy(&tparams->mac_addr, reinterpret_cast<rte_ether_addr *>(pkt + 6));
-#pragma GCC diagnostic pop
+    HOLOSCAN_LOG_INFO("TX thread for port {} queue {} exiting after sending {} packets in {} "
+        "bursts", tparams->port, tparams->queue, tparams->pkts.load(), tparams->bursts.load());
+  }
 
-      mbuf->ol_flags = RTE_MBUF_F_TX_IPV4 | RTE_MBUF_F_TX_IP_CKSUM | RTE_MBUF_F_TX_UDP_CKSUM;
-    }
+  return 0;
+}
 
-    auto pkts_to_transmit = static_cast<int64_t>(msg->hdr.num_pkts);
+int DpdkMgr::capture_core(void *arg) {
+  auto capture = static_cast<CaptureParams*>(arg);
+  CaptureRecord *recs[TX_RING_DEQUEUE_SIZE];
+  const double ns_per_tick = 1e9 / rte_get_tsc_hz();
+  bool unflushed = false;
+
+  HOLOSCAN_LOG_INFO("Starting capture core {}", rte_lcore_id());
+
+  while (true) {
+    const auto n = rte_ring_dequeue_burst(capture->ring, reinterpret_cast<void**>(recs),
+        TX_RING_DEQUEUE_SIZE, nullptr);
+    if (n == 0) {
+      // Stop is only set once every RX worker has exited, so nothing more can be queued and
+      // stopping now loses nothing
+      if (capture->stop.load()) {
+        break;
+      }
 
-    size_t pkts_tx = 0;
-    while (pkts_tx != msg->hdr.num_pkts && !force_quit.load()) {
-      auto to_send = static_cast<uint16_t>(
-            std::min(static_cast<size_t>(DEFAULT_NUM_TX_BURST), msg->hdr.num_pkts - pkts_tx));
-      int tx = rte_eth_tx_burst(tparams->port,
-            tparams->queue, reinterpret_cast<rte_mbuf**>(&msg->cpu_pkts[pkts_tx]), to_send);
+      // Push written packets to the file while idle, so little is lost if the process is killed
+      if (unflushed) {
+        capture->writer.Flush();
+        unflushed = false;
+      }
 
-      pkts_tx += tx;
+      continue;
     }
 
-    rte_mempool_put(tparams->burst_pool, static_cast<void*>(msg->cpu_pkts));
-    rte_mempool_put(tparams->meta_pool, msg);
+    for (unsigned r = 0; r < n; r++) {
+      const auto rec = recs[r];
+      const uint64_t ts_ns = capture->base_ns + (rec->tsc - capture->base_tsc) * ns_per_tick;
+      const auto if_idx = capture->if_idx[rec->port];
+      for (uint16_t p = 0; p < rec->num_pkts; p++) {
+        // Only the first segment is in host memory when header-data split is on
+        const auto m = rec->pkts[p];
+        capture->writer.Write(if_idx, ts_ns, rte_pktmbuf_mtod(m, void*), rte_pktmbuf_data_len(m),
+            rte_pktmbuf_pkt_len(m));
+      }
 
-    HOLOSCAN_LOG_DEBUG("Sent {} packets\n", pkts_tx);
+      rte_pktmbuf_free_bulk(rec->pkts, rec->num_pkts);
+      AddCounter(capture->pkts, rec->num_pkts);
+    }
 
-    bursts++;
+    rte_mempool_put_bulk(capture->pool, reinterpret_cast<void**>(recs), n);
+    unflushed = true;
   }
-  printf("TX thread exiting\n");
 
+  capture->writer.Close();
+  HOLOSCAN_LOG_INFO("Capture core exiting after writing {} packets. {} packets were received "
+      "while it was behind and not written", capture->pkts.load(), capture->missed_pkts.load());
   return 0;
 }
+
 };  // namespace holoscan::ops
@@ -17,6 +17,7 @@
 
 #pragma once
 
+#include <map>
 #include <vector>
 #include <string>
 #include <tuple>
@@ -46,10 +47,17 @@
 #include <rte_flow.h>
 #include <rte_gpudev.h>
 #include <atomic>
+#include <thread>
 #include "adv_network_common.h"
 
 namespace holoscan::ops {
 
+struct RxWorkerParams;
+struct TxWorkerParams;
+struct RxCore;
+struct TxCore;
+struct CaptureParams;
+
 class DpdkMgr {
  public:
     DpdkMgr() {
@@ -57,22 +65,46 @@ class DpdkMgr {
     }
     ~DpdkMgr();
     void SetConfigAndInitialize(const AdvNetConfigYaml &cfg);
-    int GetRxPkts(void **pkts, int num);
     void Initialize();
     void Run();
     void wait();
+    std::vector<AdvNetRxQueueStats> GetRxQueueStats() const;
+    std::vector<AdvNetTxQueueStats> GetTxQueueStats() const;
+    std::vector<AdvNetPortStats> GetPortStats() const;
+    AdvNetTelemetry GetTelemetry() const;
     static int rx_core(void *arg);
     static int tx_core(void *arg);
-    static void check_pkts_to_free(rte_ring *msg_ring,
+    static int capture_core(void *arg);
+    static int check_pkts_to_free(rte_ring *msg_ring,
           rte_mempool *burst_pool, rte_mempool *meta_pool);
+
+    // Ring and pools of a TX queue
+    struct TxQueue {
+      struct rte_ring *ring = nullptr;
+      struct rte_mempool *pkt_pool = nullptr;
+      struct rte_mempool *burst_pool = nullptr;
+      struct rte_mempool *meta_pool = nullptr;
+    };
+
+    // Get a TX queue, or nullptr if it was not configured
+    const TxQueue *GetTxQueue(uint16_t port, uint16_t q) const;
+
+    // Whether a port computes IPv4 and UDP checksums of sent packets in hardware
+    bool TxChecksumOffload(uint16_t port) const;
+    // Whether a port can send packets made of several segments
+    bool TxMultiSegOffload(uint16_t port) const;
+    // Get the configuration of a TX queue, or nullptr if it was not configured
+    const TxQueueConfig *GetTxQueueConfig(uint16_t port, uint16_t q) const;
+    // Register application memory that TX payloads are attached from, and map it for every NIC
+    bool RegisterTxMemory(void *addr, size_t len);
     static constexpr int JUMBFRAME_SIZE = 9100;
     static constexpr int DEFAULT_NUM_TX_BURST = 256;
     static constexpr int DEFAULT_NUM_RX_BURST = 1024;
+    static constexpr int TX_RING_DEQUEUE_SIZE = 32;
     uint16_t default_num_rx_desc = 8192;
     uint16_t default_num_tx_desc = 8192;
     int num_ports = 0;
     static constexpr int MAX_IFS = 4;
-    static constexpr int num_lcores = 2;
     static constexpr int MEMPOOL_CACHE_SIZE = 32;
     static constexpr int MAX_PKT_BURST = 64;
     static constexpr uint32_t GPU_PAGE_SHIFT = 16;
@@ -82,12 +114,33 @@ class DpdkMgr {
     static constexpr uint32_t CPU_PAGE_SIZE = 4096;
     static constexpr int BUFFER_SPLIT_SEGS = 2;
     static constexpr int MAX_ETH_HDR_SIZE = 18;
+    // Space after each RX meta pool burst where AdvNetworkOpRx builds its shared_ptr control block
+    static constexpr int RX_META_CTRL_SIZE = 128;
+
+    // Name of the ring bursts from an RX queue are passed to the operator on
+    static std::string RxRingName(uint16_t port, int q);
 
 
  private:
     static void flush_packets(int port);
+    static AdvNetBurstParams *GetRxBurst(RxWorkerParams *tparams);
+    static void poll_rx_queue(RxWorkerParams *tparams);
+    static void poll_tx_queue(TxWorkerParams *tparams);
+    static bool ParseCpuList(const std::string &list, std::vector<int> &cpus);
+    int AssignLcore(const CommonQueueConfig &q, uint16_t port, AdvNetDirection dir);
+    static int PortSocket(uint16_t port);
     struct rte_flow *AddFlow(int port, const FlowConfig &cfg);
     std::string GetQueueName(int port, int q, AdvNetDirection dir);
+    bool IsVirtual(const std::string &if_name) const;
+    bool CreateRxBurstQueue(uint16_t port, RxQueueConfig &q);
+    bool CreateTxQueue(uint16_t port, TxQueueConfig &q);
+    bool CreateReplay(uint16_t port, RxQueueConfig &q);
+    bool CreateCapture();
+    void StopCapture();
+    void TelemetryLoop();
+    void StopTelemetry();
+    void LogTelemetry(const AdvNetTelemetry &prev, const AdvNetTelemetry &cur) const;
+    void WriteTelemetryFile(const AdvNetTelemetry &cur) const;
 
     AdvNetConfigYaml cfg_;
     std::array<std::string, MAX_IFS> if_names;
@@ -95,13 +148,19 @@ class DpdkMgr {
     std::array<struct rte_ether_addr, MAX_IFS> mac_addrs;
     struct rte_ether_addr conf_ports_eth_addr[RTE_MAX_ETHPORTS];
     struct rte_pktmbuf_extmem ext_mem;
-    struct rte_ring *rx_ring;
-    struct rte_ring *tx_ring;
-    struct rte_mempool *rx_burst_buffer;
-    struct rte_mempool *rx_meta;
-    struct rte_mempool *tx_meta;
-    struct rte_mempool *tx_burst_buffer;
+    std::array<std::array<TxQueue, MAX_NUM_TX_QUEUES>, MAX_INTERFACES> tx_queues;
     std::array<struct rte_eth_conf, MAX_INTERFACES> local_port_conf;
+    std::array<uint64_t, MAX_INTERFACES> tx_offloads{};   // TX offloads enabled on each port
+    std::vector<RxWorkerParams *> rx_workers;
+    std::vector<TxWorkerParams *> tx_workers;
+    std::vector<RxCore *> rx_cores;
+    std::vector<TxCore *> tx_cores;
+    std::map<int, int> lcore_num_queues;        // Queues polled by each worker core
+    std::map<int, AdvNetDirection> lcore_dir;   // Whether each worker core receives or transmits
+    CaptureParams *capture = nullptr;       // Set when received packets are written to a file
+    std::thread telemetry_thread;           // Exports telemetry every telemetry_interval_ms
+    std::atomic<bool> telemetry_stop = false;
+    std::vector<std::string> eal_args;     // EAL arguments. EAL may keep pointers into them
 
     bool initialized = false;
     int num_init = 0;
@@ -0,0 +1,301 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <errno.h>
+#include <string.h>
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include "adv_network_pcap.h"
+#include "holoscan/holoscan.hpp"
+
+namespace holoscan::ops {
+
+static constexpr uint32_t PCAP_MAGIC_US = 0xa1b2c3d4;
+static constexpr uint32_t PCAP_MAGIC_NS = 0xa1b23c4d;
+static constexpr uint32_t PCAP_HDR_SIZE = 24;
+static constexpr uint32_t PCAP_REC_HDR_SIZE = 16;
+
+static constexpr uint32_t PCAPNG_SHB = 0x0a0d0d0a;
+static constexpr uint32_t PCAPNG_IDB = 1;
+static constexpr uint32_t PCAPNG_SPB = 3;
+static constexpr uint32_t PCAPNG_EPB = 6;
+static constexpr uint32_t PCAPNG_BYTE_ORDER_MAGIC = 0x1a2b3c4d;
+static constexpr uint16_t PCAPNG_OPT_END = 0;
+static constexpr uint16_t PCAPNG_OPT_IF_NAME = 2;
+static constexpr uint16_t PCAPNG_OPT_IF_TSRESOL = 9;
+static constexpr uint16_t LINKTYPE_ETHERNET = 1;
+
+// Writer buffer size. Large enough that the capture core rarely makes a system call
+static constexpr size_t WRITE_BUF_SIZE = 4 * 1024 * 1024;
+
+static uint32_t Read32(const uint8_t *p, bool swap) {
+  uint32_t v;
+  memcpy(&v, p, sizeof(v));
+  return swap ? __builtin_bswap32(v) : v;
+}
+
+static uint16_t Read16(const uint8_t *p, bool swap) {
+  uint16_t v;
+  memcpy(&v, p, sizeof(v));
+  return swap ? __builtin_bswap16(v) : v;
+}
+
+bool PcapFile::Load(const std::string &path) {
+  std::ifstream in(path, std::ios::binary);
+  if (!in) {
+    HOLOSCAN_LOG_ERROR("Failed to open capture file {}", path);
+    return false;
+  }
+
+  data_.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+  pkts_.clear();
+  if (data_.size() < sizeof(uint32_t)) {
+    HOLOSCAN_LOG_ERROR("Capture file {} is too short", path);
+    return false;
+  }
+
+  const bool ok = Read32(data_.data(), false) == PCAPNG_SHB ? ParsePcapng() : ParsePcap();
+  if (!ok) {
+    HOLOSCAN_LOG_ERROR("Capture file {} is not a valid Ethernet pcap or pcapng file", path);
+    return false;
+  }
+
+  HOLOSCAN_LOG_INFO("Loaded {} packets from {}", pkts_.size(), path);
+  return true;
+}
+
+bool PcapFile::ParsePcap() {
+  if (data_.size() < PCAP_HDR_SIZE) {
+    return false;
+  }
+
+  const uint32_t magic = Read32(data_.data(), false);
+  bool swap;
+  bool nsec;
+  if (magic == PCAP_MAGIC_US || magic == PCAP_MAGIC_NS) {
+    swap = false;
+    nsec = magic == PCAP_MAGIC_NS;
+  } else if (magic == __builtin_bswap32(PCAP_MAGIC_US) ||
+             magic == __builtin_bswap32(PCAP_MAGIC_NS)) {
+    swap = true;
+    nsec = magic == __builtin_bswap32(PCAP_MAGIC_NS);
+  } else {
+    return false;
+  }
+
+  // Replayed packets are handed out as Ethernet frames, so any other link layer is unusable. The
+  // upper bits of the field carry FCS information
+  const uint16_t link_type = Read32(data_.data() + 20, swap) & 0xffff;
+  if (link_type != LINKTYPE_ETHERNET) {
+    HOLOSCAN_LOG_ERROR("Capture file link type is {}; only Ethernet ({}) can be replayed",
+        link_type, LINKTYPE_ETHERNET);
+    return false;
+  }
+
+  size_t off = PCAP_HDR_SIZE;
+  while (off + PCAP_REC_HDR_SIZE <= data_.size()) {
+    const uint8_t *rec = data_.data() + off;
+    const uint64_t secs = Read32(rec, swap);
+    const uint64_t frac = Read32(rec + 4, swap);
+    const uint32_t caplen = Read32(rec + 8, swap);
+    off += PCAP_REC_HDR_SIZE;
+    if (off + caplen > data_.size()) {
+      HOLOSCAN_LOG_WARN("Capture file ends in the middle of a packet");
+      break;
+    }
+
+    pkts_.push_back({secs * 1000000000 + (nsec ? frac : frac * 1000), off, caplen});
+    off += caplen;
+  }
+
+  return true;
+}
+
+bool PcapFile::ParsePcapng() {
+  bool swap = false;
+  std::vector<uint8_t> if_tsresol;  // Timestamp resolution of each interface in this section
+  uint64_t last_ts = 0;
+  size_t off = 0;
+
+  while (off + 12 <= data_.size()) {
+    const uint8_t *blk = data_.data() + off;
+    uint32_t type = Read32(blk, swap);
+    if (type == PCAPNG_SHB) {
+      // The byte order magic decides how the rest of the section is read
+      const uint32_t bom = Read32(blk + 8, false);
+      if (bom == PCAPNG_BYTE_ORDER_MAGIC) {
+        swap = false;
+      } else if (bom == __builtin_bswap32(PCAPNG_BYTE_ORDER_MAGIC)) {
+        swap = true;
+      } else {
+        return false;
+      }
+
+      if_tsresol.clear();
+    }
+
+    const uint32_t blk_len = Read32(blk + 4, swap);
+    if (blk_len < 12 || blk_len % 4 != 0 || off + blk_len > data_.size()) {
+      HOLOSCAN_LOG_WARN("Capture file ends in the middle of a block");
+      break;
+    }
+
+    const uint8_t *body = blk + 8;
+    const uint8_t *end = blk + blk_len - 4;
+    if (type == PCAPNG_IDB && body + 8 <= end) {
+      const uint16_t link_type = Read16(body, swap);
+      if (link_type != LINKTYPE_ETHERNET) {
+        HOLOSCAN_LOG_ERROR("Capture interface {} has link type {}; only Ethernet ({}) can be "
+            "replayed", if_tsresol.size(), link_type, LINKTYPE_ETHERNET);
+        return false;
+      }
+
+      // Timestamps default to microseconds unless the interface has an if_tsresol option
+      uint8_t tsresol = 6;
+      const uint8_t *opt = body + 8;
+      while (opt + 4 <= end) {
+        const uint16_t code = Read16(opt, swap);
+        const uint16_t len = Read16(opt + 2, swap);
+        if (code == PCAPNG_OPT_END) {
+          break;
+        }
+
+        if (code == PCAPNG_OPT_IF_TSRESOL && len >= 1) {
+          tsresol = opt[4];
+        }
+
+        opt += 4 + ((len + 3) & ~3);
+      }
+
+      if_tsresol.push_back(tsresol);
+    } else if (type == PCAPNG_EPB && body + 20 <= end) {
+      const uint32_t if_id = Read32(body, swap);
+      const uint64_t ts = (static_cast<uint64_t>(Read32(body + 4, swap)) << 32) |
+                          Read32(body + 8, swap);
+      const uint32_t caplen = Read32(body + 12, swap);
+      if (body + 20 + caplen > end) {
+        return false;
+      }
+
+      const uint8_t tsresol = if_id < if_tsresol.size() ? if_tsresol[if_id] : 6;
+      const uint8_t exp = tsresol & 0x7f;
+      uint64_t ts_ns;
+      if (tsresol & 0x80) {
+        ts_ns = static_cast<uint64_t>(static_cast<unsigned __int128>(ts) * 1000000000 >> exp);
+      } else {
+        ts_ns = ts;
+        for (int e = exp; e < 9; e++) { ts_ns *= 10; }
+        for (int e = 9; e < exp; e++) { ts_ns /= 10; }
+      }
+
+      last_ts = ts_ns;
+      pkts_.push_back({ts_ns, static_cast<size_t>(body + 20 - data_.data()), caplen});
+    } else if (type == PCAPNG_SPB && body + 4 <= end) {
+      // Simple packet blocks have no timestamp, so they are replayed with the packet before them
+      const uint32_t len = std::min<uint32_t>(Read32(body, swap), end - body - 4);
+      pkts_.push_back({last_ts, static_cast<size_t>(body + 4 - data_.data()), len});
+    }
+
+    off += blk_len;
+  }
+
+  return true;
+}
+
+bool PcapngWriter::Open(const std::string &path, const std::vector<std::string> &if_names) {
+  fp_ = fopen(path.c_str(), "wb");
+  if (fp_ == nullptr) {
+    HOLOSCAN_LOG_ERROR("Failed to create capture file {}: {}", path, strerror(errno));
+    return false;
+  }
+
+  buf_.resize(WRITE_BUF_SIZE);
+  setvbuf(fp_, buf_.data(), _IOFBF, buf_.size());
+
+  auto put16 = [](std::vector<uint8_t> &b, uint16_t v) {
+    b.insert(b.end(), reinterpret_cast<uint8_t*>(&v), reinterpret_cast<uint8_t*>(&v) + 2);
+  };
+  auto put32 = [](std::vector<uint8_t> &b, uint32_t v) {
+    b.insert(b.end(), reinterpret_cast<uint8_t*>(&v), reinterpret_cast<uint8_t*>(&v) + 4);
+  };
+
+  // Section header: byte order magic, version 1.0, and an unknown section length
+  std::vector<uint8_t> shb;
+  put32(shb, PCAPNG_BYTE_ORDER_MAGIC);
+  put16(shb, 1);
+  put16(shb, 0);
+  put32(shb, 0xffffffff);
+  put32(shb, 0xffffffff);
+  WriteBlock(PCAPNG_SHB, shb);
+
+  for (const auto &name : if_names) {
+    std::vector<uint8_t> idb;
+    put16(idb, LINKTYPE_ETHERNET);
+    put16(idb, 0);
+    put32(idb, 0);  // No snap length limit
+    put16(idb, PCAPNG_OPT_IF_NAME);
+    put16(idb, name.size());
+    idb.insert(idb.end(), name.begin(), name.end());
+    idb.resize((idb.size() + 3) & ~3);
+    put16(idb, PCAPNG_OPT_IF_TSRESOL);
+    put16(idb, 1);
+    idb.insert(idb.end(), {9, 0, 0, 0});  // Nanoseconds
+    put16(idb, PCAPNG_OPT_END);
+    put16(idb, 0);
+    WriteBlock(PCAPNG_IDB, idb);
+  }
+
+  return true;
+}
+
+void PcapngWriter::WriteBlock(uint32_t type, const std::vector<uint8_t> &body) {
+  const uint32_t len = body.size() + 12;
+  fwrite(&type, sizeof(type), 1, fp_);
+  fwrite(&len, sizeof(len), 1, fp_);
+  fwrite(body.data(), 1, body.size(), fp_);
+  fwrite(&len, sizeof(len), 1, fp_);
+}
+
+void PcapngWriter::Write(uint32_t if_idx, uint64_t ts_ns, const void *data, uint32_t caplen,
+                         uint32_t len) {
+  static constexpr uint8_t pad[4] = {};
+  const uint32_t padded = (caplen + 3) & ~3;
+  const uint32_t hdr[7] = {PCAPNG_EPB, 32 + padded, if_idx, static_cast<uint32_t>(ts_ns >> 32),
+                           static_cast<uint32_t>(ts_ns), caplen, len};
+  const uint32_t blk_len = hdr[1];
+
+  fwrite(hdr, sizeof(hdr), 1, fp_);
+  fwrite(data, 1, caplen, fp_);
+  fwrite(pad, 1, padded - caplen, fp_);
+  fwrite(&blk_len, sizeof(blk_len), 1, fp_);
+}
+
+void PcapngWriter::Flush() {
+  if (fp_ != nullptr) {
+    fflush(fp_);
+  }
+}
+
+void PcapngWriter::Close() {
+  if (fp_ != nullptr) {
+    fclose(fp_);
+    fp_ = nullptr;
+  }
+}
+
+};  // namespace holoscan::ops
@@ -0,0 +1,111 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+namespace holoscan::ops {
+
+/**
+ * @brief A packet in a capture file loaded by PcapFile
+ *
+ */
+struct PcapPacket {
+  uint64_t ts_ns;   // Capture time in nanoseconds
+  size_t offset;    // Offset of the packet data in the file
+  uint32_t len;     // Captured length, which may be shorter than the packet on the wire
+};
+
+/**
+ * @brief Packets of a pcap or pcapng file, read into memory for replay
+ *
+ * The whole file is read up front so that replaying it never waits on storage. Packets point into
+ * the file contents rather than being copied out. Both the classic pcap format, in either byte
+ * order and with microsecond or nanosecond timestamps, and pcapng are supported. Every interface
+ * in the file must have the Ethernet link type.
+ */
+class PcapFile {
+ public:
+  /**
+   * @brief Read a capture file
+   *
+   * @param path Path of the pcap or pcapng file
+   * @return true if the file was read, false if it could not be read, is not a capture file, or
+   * holds anything but Ethernet frames
+   */
+  bool Load(const std::string &path);
+
+  const std::vector<PcapPacket> &Packets() const { return pkts_; }
+  const uint8_t *Data(const PcapPacket &pkt) const { return data_.data() + pkt.offset; }
+
+ private:
+  bool ParsePcap();
+  bool ParsePcapng();
+
+  std::vector<uint8_t> data_;
+  std::vector<PcapPacket> pkts_;
+};
+
+/**
+ * @brief Writes packets to a pcapng file
+ *
+ * Each interface gets an interface description block with nanosecond timestamps, and packets are
+ * written as enhanced packet blocks. Writes are buffered; Flush() pushes them to the file.
+ */
+class PcapngWriter {
+ public:
+  PcapngWriter() = default;
+  ~PcapngWriter() { Close(); }
+
+  PcapngWriter(const PcapngWriter &) = delete;
+  PcapngWriter &operator=(const PcapngWriter &) = delete;
+
+  /**
+   * @brief Create the file and write its section header
+   *
+   * @param path Path of the file to create
+   * @param if_names Name of each interface. Packets refer to interfaces by index in this list
+   * @return true if the file was created
+   */
+  bool Open(const std::string &path, const std::vector<std::string> &if_names);
+
+  /**
+   * @brief Write a packet
+   *
+   * @param if_idx Index of the interface the packet was received on
+   * @param ts_ns Receive time in nanoseconds since the epoch
+   * @param data Packet data
+   * @param caplen Bytes of data to write
+   * @param len Length of the packet on the wire
+   */
+  void Write(uint32_t if_idx, uint64_t ts_ns, const void *data, uint32_t caplen, uint32_t len);
+
+  void Flush();
+  void Close();
+
+ private:
+  void WriteBlock(uint32_t type, const std::vector<uint8_t> &body);
+
+  FILE *fp_ = nullptr;
+  std::vector<char> buf_;
+};
+
+};  // namespace holoscan::ops
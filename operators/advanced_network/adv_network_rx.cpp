@@ -17,16 +17,59 @@
 
 #include "adv_network_rx.h"
 #include "adv_network_dpdk_mgr.h"
+#include <algorithm>
 #include <memory>
+#include <new>
+#include <utility>
+#include <vector>
 
 namespace holoscan::ops {
 
+/**
+ * @brief Allocator that places a burst's shared_ptr control block in the spare space after the
+ * burst in its RX meta pool buffer, so handing a burst downstream does not touch the heap.
+ *
+ * The burst must stay out of the pool until the control block is gone, which is after the
+ * shared_ptr deleter runs. deallocate() is the last use of the control block, so it is what
+ * returns the buffer to the pool and the deleter does nothing.
+ */
+template <typename T>
+struct RxBurstCtrlAllocator {
+  using value_type = T;
+
+  explicit RxBurstCtrlAllocator(AdvNetBurstParams *burst) : burst(burst) {}
+  template <typename U>
+  RxBurstCtrlAllocator(const RxBurstCtrlAllocator<U> &other) : burst(other.burst) {}
+
+  T *allocate(size_t n) {
+    if (n * sizeof(T) > DpdkMgr::RX_META_CTRL_SIZE) {
+      HOLOSCAN_LOG_CRITICAL("shared_ptr control block of {} bytes does not fit in RX meta buffer",
+          n * sizeof(T));
+      throw std::bad_alloc();
+    }
+
+    return reinterpret_cast<T *>(burst + 1);
+  }
+
+  // Each queue has its own meta pool, which is found from the buffer itself
+  void deallocate(T *, size_t) { rte_mempool_put(rte_mempool_from_obj(burst), burst); }
+
+  template <typename U>
+  bool operator==(const RxBurstCtrlAllocator<U> &other) const { return burst == other.burst; }
+  template <typename U>
+  bool operator!=(const RxBurstCtrlAllocator<U> &other) const { return burst != other.burst; }
+
+  AdvNetBurstParams *burst;
+};
+
 struct AdvNetworkOpRx::AdvNetworkOpRxImpl {
   DpdkMgr *dpdk_mgr;
-  struct rte_ring *rx_ring;
-  struct rte_mempool *rx_desc_pool;
-  struct rte_mempool *rx_meta_pool;
+  std::vector<struct rte_ring *> rx_rings;  // Rings of the queues this operator subscribes to
+  std::vector<std::pair<uint16_t, int>> rx_queues;  // Port and queue ID of each ring
+  size_t next_ring = 0;                     // Ring compute() visits first
   AdvNetConfigYaml cfg;
+  std::vector<AdvNetBurstParams *> bursts;  // Dequeue space for rx_bursts_per_tick bursts
+  AdvNetRxRingStats stats;
 };
 
 
@@ -39,6 +82,12 @@ void AdvNetworkOpRx::setup(OperatorSpec& spec) {
       "Configuration",
       "Configuration for the advanced network operator",
       AdvNetConfigYaml());
+  spec.param(
+      queues_,
+      "queues",
+      "Queues",
+      "IDs of the RX queues to emit bursts from. Empty subscribes to every queue",
+      std::vector<int>());
 }
 
 void AdvNetworkOpRx::initialize() {
@@ -54,40 +103,125 @@ int AdvNetworkOpRx::Init() {
   impl->cfg = cfg_.get();
   impl->dpdk_mgr = &dpdk_mgr;
   impl->dpdk_mgr->SetConfigAndInitialize(impl->cfg);
-  impl->rx_desc_pool = nullptr;
-  impl->rx_ring = nullptr;
+
+  // The manager creates a ring per queue during initialization, so they can be looked up once
+  // here. Each ring has a single consumer, so a queue must not be subscribed to twice.
+  const auto &queues = queues_.get();
+  for (const auto &rx : impl->cfg.rx_) {
+    uint16_t port;
+    if (rte_eth_dev_get_port_by_name(rx.if_name_.c_str(), &port) < 0) {
+      HOLOSCAN_LOG_CRITICAL("Failed to get port number for {}", rx.if_name_);
+      return -1;
+    }
+
+    for (const auto &q : rx.queues_) {
+      if (!queues.empty() &&
+          std::find(queues.begin(), queues.end(), q.common_.id_) == queues.end()) {
+        continue;
+      }
+
+      auto ring = rte_ring_lookup(DpdkMgr::RxRingName(port, q.common_.id_).c_str());
+      if (ring == nullptr) {
+        HOLOSCAN_LOG_CRITICAL("Failed to find RX ring for port {} queue {}. Was the DPDK manager "
+            "initialized?", port, q.common_.id_);
+        return -1;
+      }
+
+      HOLOSCAN_LOG_INFO("RX operator {} subscribed to port {} queue {}", name(), port,
+          q.common_.id_);
+      impl->rx_rings.push_back(ring);
+      impl->rx_queues.emplace_back(port, q.common_.id_);
+    }
+  }
+
+  if (impl->rx_rings.empty()) {
+    HOLOSCAN_LOG_CRITICAL("RX operator {} is not subscribed to any queues", name());
+    return -1;
+  }
+
+  impl->bursts.resize(std::max(impl->cfg.common_.rx_bursts_per_tick_, 1));
 
   return 0;
 }
 
+AdvNetworkOpRx::~AdvNetworkOpRx() {
+  if (impl == nullptr) {
+    return;
+  }
+
+  const auto &stats = impl->stats;
+  if (stats.polls > 0) {
+    HOLOSCAN_LOG_INFO("RX rings: {} bursts in {} polls ({} empty), occupancy mean {:.1f} max {}",
+        stats.bursts, stats.polls, stats.empty_polls,
+        static_cast<double>(stats.occupancy_sum) / stats.polls, stats.max_occupancy);
+  }
+
+  for (const auto &q : impl->dpdk_mgr->GetRxQueueStats()) {
+    const auto &subscribed = impl->rx_queues;
+    const auto queue = std::make_pair(q.port_id, static_cast<int>(q.q_id));
+    if (std::find(subscribed.begin(), subscribed.end(), queue) == subscribed.end()) {
+      continue;
+    }
+
+    HOLOSCAN_LOG_INFO("RX port {} queue {}: {} packets in {} bursts ({} full, {} on timeout), "
+        "{} packets dropped, {} bursts recycled, {} stalls for {} ns", q.port_id, q.q_id, q.pkts,
+        q.bursts, q.bursts - q.timeout_bursts, q.timeout_bursts, q.dropped_pkts,
+        q.recycled_bursts, q.stalls, q.stall_ns);
+  }
+
+  delete impl;
+}
+
+AdvNetRxRingStats AdvNetworkOpRx::GetRingStats() const {
+  return impl->stats;
+}
+
 
 
 void AdvNetworkOpRx::compute([[maybe_unused]] InputContext&, OutputContext& op_output,
       [[maybe_unused]] ExecutionContext&) {
-  int n;
-  AdvNetBurstParams *burst;
-
-  if (unlikely(impl->rx_ring == nullptr)) {
-    impl->rx_ring = rte_ring_lookup("RX_RING");
+  // Rings are visited round-robin, starting one further along each tick so no queue is starved
+  auto &stats = impl->stats;
+  const auto &rings = impl->rx_rings;
+  unsigned int n = 0;
+  unsigned int occupancy = 0;
+  for (size_t r = 0; r < rings.size() && n < impl->bursts.size(); r++) {
+    unsigned int left;
+    n += rte_ring_dequeue_burst(rings[(impl->next_ring + r) % rings.size()],
+        reinterpret_cast<void**>(&impl->bursts[n]), impl->bursts.size() - n, &left);
+    occupancy += left;
   }
 
-  if (unlikely(impl->rx_desc_pool == nullptr)) {
-    impl->rx_desc_pool = rte_mempool_lookup("RX_BURST_POOL");
-  }
+  impl->next_ring = (impl->next_ring + 1) % rings.size();
 
-  if (unlikely(impl->rx_meta_pool == nullptr)) {
-    impl->rx_meta_pool = rte_mempool_lookup("RX_META_POOL");
+  stats.polls++;
+  stats.occupancy_sum += occupancy;
+  stats.max_occupancy = std::max(stats.max_occupancy, occupancy);
+  if (n == 0) {
+    stats.empty_polls++;
+    return;
   }
 
-  if (rte_ring_dequeue(impl->rx_ring, reinterpret_cast<void**>(&burst)) < 0) {
+  stats.bursts += n;
+
+  // The meta pool buffers themselves go downstream, and return to the pool with the last reference
+  auto wrap = [this](AdvNetBurstParams *burst) {
+    return std::shared_ptr<AdvNetBurstParams>(burst, [](AdvNetBurstParams *) {},
+        RxBurstCtrlAllocator<AdvNetBurstParams>(burst));
+  };
+
+  if (impl->cfg.common_.rx_bursts_per_tick_ <= 1) {
+    op_output.emit(wrap(impl->bursts[0]), "burst_out");
     return;
   }
 
-  auto adv_burst = std::make_shared<AdvNetBurstParams>();
-  memcpy(adv_burst.get(), burst, sizeof(*burst));
-  rte_mempool_put(impl->rx_meta_pool, burst);
+  auto list = std::make_shared<AdvNetBurstList>();
+  list->reserve(n);
+  for (unsigned int b = 0; b < n; b++) {
+    list->push_back(wrap(impl->bursts[b]));
+  }
 
-  op_output.emit(adv_burst, "burst_out");
+  op_output.emit(list, "burst_out");
 }
 
 };  // namespace holoscan::ops
@@ -18,6 +18,7 @@
 #pragma once
 
 #include <memory>
+#include <vector>
 #include "adv_network_common.h"
 #include "holoscan/holoscan.hpp"
 #include <experimental/propagate_const>
@@ -25,6 +26,22 @@
 
 
 namespace holoscan::ops {
+
+/**
+ * @brief Occupancy of the rings RX workers pass bursts to the operator on
+ *
+ * Occupancy is the bursts left in the rings the operator visited, sampled after each dequeue.
+ * A mean or maximum that keeps growing means the workers are outpacing the operator and will
+ * eventually run out of burst buffers.
+ */
+struct AdvNetRxRingStats {
+  uint64_t polls = 0;           // compute() calls
+  uint64_t empty_polls = 0;     // compute() calls that found every ring empty
+  uint64_t bursts = 0;          // Bursts emitted
+  uint64_t occupancy_sum = 0;   // Sum of the bursts left in the rings after each dequeue
+  uint32_t max_occupancy = 0;   // Most bursts left in the rings after a dequeue
+};
+
 /*
   Class for handling data from a high-speed network. This can be used for low-speed networks too,
   but requires more configuration that's not necessarily needed with low-speed networks.
@@ -36,7 +53,7 @@ class AdvNetworkOpRx : public Operator {
  public:
     HOLOSCAN_OPERATOR_FORWARD_ARGS(AdvNetworkOpRx);
     AdvNetworkOpRx() = default;
-    ~AdvNetworkOpRx() = default;
+    ~AdvNetworkOpRx();
 
     void initialize() override;
     int Init();
@@ -46,10 +63,15 @@ class AdvNetworkOpRx : public Operator {
     void setup(OperatorSpec& spec) override;
     void compute(InputContext&, OutputContext& op_output, ExecutionContext&) override;
 
+    /**
+     * @brief Get the occupancy of the rings between the RX workers and this operator
+     */
+    AdvNetRxRingStats GetRingStats() const;
+
 
  private:
     static constexpr int RX_BURST_SIZE = 128;
-    AdvNetworkOpRxImpl *impl;
+    AdvNetworkOpRxImpl *impl = nullptr;
     Parameter<std::string> if_name_;
     Parameter<std::string> cpu_cores_;
     Parameter<std::string> master_core_;
@@ -60,6 +82,7 @@ class AdvNetworkOpRx : public Operator {
     Parameter<int> max_packet_size_;
     Parameter<uint32_t> num_concurrent_batches_;
     Parameter<AdvNetConfigYaml> cfg_;
+    Parameter<std::vector<int>> queues_;
 };
 
 };  // namespace holoscan::ops
@@ -26,8 +26,6 @@ namespace holoscan::ops {
 
 struct AdvNetworkOpTx::AdvNetworkOpTxImpl {
   DpdkMgr *dpdk_mgr;
-  struct rte_ring *tx_ring;
-  struct rte_mempool *tx_meta_pool;
   AdvNetConfigYaml cfg;
 };
 
@@ -61,7 +59,6 @@ int AdvNetworkOpTx::Init() {
   impl = new AdvNetworkOpTxImpl();
   impl->cfg = cfg_.get();;
   impl->dpdk_mgr = &dpdk_mgr;
-  impl->tx_ring = nullptr;
   impl->dpdk_mgr->SetConfigAndInitialize(impl->cfg);
 
   // Set up all LUTs for speed
@@ -73,9 +70,16 @@ int AdvNetworkOpTx::Init() {
     }
 
     auto port = port_opt.value();
+    rte_eth_macaddr_get(port, reinterpret_cast<rte_ether_addr*>(&raw_eth_src_[port][0]));
+    hw_cksum_[port] = impl->dpdk_mgr->TxChecksumOffload(port);
 
     for (auto &q : tx.queues_) {
       auto q_id       = q.common_.id_;
+      if (impl->dpdk_mgr->GetTxQueue(port, q_id) == nullptr) {
+        HOLOSCAN_LOG_CRITICAL("TX port {} queue {} was not created", port, q_id);
+        return -1;
+      }
+
       auto fill_type  = q.fill_type_;
       if (fill_type == "eth") {
         fill[port][q_id] = FILL_ETH;
@@ -107,54 +111,70 @@ int AdvNetworkOpTx::Init() {
 
 void AdvNetworkOpTx::compute(InputContext& op_input, [[maybe_unused]] OutputContext& op_output,
       [[maybe_unused]] ExecutionContext&) {
-  int n;
-
-  if (unlikely(impl->tx_ring == nullptr)) {
-    impl->tx_ring = rte_ring_lookup("TX_RING");
-  }
-
-  if (unlikely(impl->tx_meta_pool == nullptr)) {
-    impl->tx_meta_pool = rte_mempool_lookup("TX_META_POOL");
-  }
-
   auto burst = op_input.receive<AdvNetBurstParams>("burst_in");
   auto port_id = burst->hdr.port_id;
   auto q_id    = burst->hdr.q_id;
 
-  if (fill[port_id][q_id] >= FILL_ETH) {
-    for (size_t p = 0; p < burst->hdr.num_pkts; p++) {
-      auto *pkt = rte_pktmbuf_mtod((rte_mbuf*)burst->cpu_pkts[p], UDPPkt*);
-      memcpy(reinterpret_cast<void*>(&pkt->eth.dst_addr),
-             reinterpret_cast<void*>(&raw_eth_dst_[port_id][q_id][0]),
-             sizeof(raw_eth_dst_[port_id][q_id]));
-    }
+  auto txq = impl->dpdk_mgr->GetTxQueue(port_id, q_id);
+  if (unlikely(txq == nullptr)) {
+    HOLOSCAN_LOG_CRITICAL("Burst sent to port {} queue {}, which is not a TX queue", port_id, q_id);
+    return;
   }
-  if (fill[port_id][q_id] >= FILL_IP) {
+
+  // Bursts built from a header template already have every header field and checksum set
+  if (!burst->hdr.hdrs_complete) {
+    // Write every header field in one pass so each packet is only touched once. The NIC needs the
+    // header lengths and the pseudo-header checksum to fill in the checksums.
+    const auto fill_type = fill[port_id][q_id];
+    const bool hw_cksum = hw_cksum_[port_id];
     for (size_t p = 0; p < burst->hdr.num_pkts; p++) {
-      auto *pkt = rte_pktmbuf_mtod((rte_mbuf*)burst->cpu_pkts[p], UDPPkt*);
-      pkt->ip.src_addr = raw_ip_src_[port_id][q_id];
-      pkt->ip.dst_addr = raw_ip_dst_[port_id][q_id];
+      auto mbuf = reinterpret_cast<rte_mbuf*>(burst->cpu_pkts[p]);
+      auto *pkt = rte_pktmbuf_mtod(mbuf, UDPPkt*);
+      memcpy(reinterpret_cast<void*>(&pkt->eth.src_addr),
+             reinterpret_cast<void*>(&raw_eth_src_[port_id][0]),
+             sizeof(raw_eth_src_[port_id]));
+      if (fill_type >= FILL_ETH) {
+        memcpy(reinterpret_cast<void*>(&pkt->eth.dst_addr),
+               reinterpret_cast<void*>(&raw_eth_dst_[port_id][q_id][0]),
+               sizeof(raw_eth_dst_[port_id][q_id]));
+      }
+      if (fill_type >= FILL_IP) {
+        pkt->ip.src_addr = raw_ip_src_[port_id][q_id];
+        pkt->ip.dst_addr = raw_ip_dst_[port_id][q_id];
+      }
+      if (fill_type >= FILL_UDP) {
+        pkt->udp.src_port = raw_udp_src_port_[port_id][q_id];
+        pkt->udp.dst_port = raw_udp_dst_port_[port_id][q_id];
+      }
+
+      if (hw_cksum) {
+        mbuf->ol_flags = RTE_MBUF_F_TX_IPV4 | RTE_MBUF_F_TX_IP_CKSUM | RTE_MBUF_F_TX_UDP_CKSUM;
+        mbuf->l2_len = sizeof(pkt->eth);
+        mbuf->l3_len = sizeof(pkt->ip);
+        pkt->ip.hdr_checksum = 0;
+        pkt->udp.dgram_cksum = rte_ipv4_phdr_cksum(
+            rte_pktmbuf_mtod_offset(mbuf, rte_ipv4_hdr*, sizeof(pkt->eth)), mbuf->ol_flags);
+      } else {
+        mbuf->ol_flags = 0;
+      }
     }
-  }
 
-  if (fill[port_id][q_id] >= FILL_UDP) {
-    for (size_t p = 0; p < burst->hdr.num_pkts; p++) {
-      auto *pkt = rte_pktmbuf_mtod((rte_mbuf*)burst->cpu_pkts[p], UDPPkt*);
-      pkt->udp.src_port = raw_udp_src_port_[port_id][q_id];
-      pkt->udp.dst_port = raw_udp_dst_port_[port_id][q_id];
+    if (!hw_cksum) {
+      adv_net_udp_checksum_burst(burst);
     }
   }
 
   AdvNetBurstParams *d_params;
-  if (rte_mempool_get(impl->tx_meta_pool, reinterpret_cast<void**>(&d_params)) != 0) {
+  if (rte_mempool_get(txq->meta_pool, reinterpret_cast<void**>(&d_params)) != 0) {
     HOLOSCAN_LOG_CRITICAL("Failed to get TX meta descriptor");
     return;
   }
 
   rte_memcpy(static_cast<void*>(d_params), burst.get(), sizeof(*burst));
-  if (rte_ring_enqueue(impl->tx_ring, reinterpret_cast<void *>(d_params)) != 0) {
+  if (rte_ring_enqueue(txq->ring, reinterpret_cast<void *>(d_params)) != 0) {
+    rte_pktmbuf_free_bulk(reinterpret_cast<rte_mbuf**>(burst->cpu_pkts), burst->hdr.num_pkts);
     adv_net_free_tx_burst(burst.get());
-    rte_mempool_put(impl->tx_meta_pool, d_params);
+    rte_mempool_put(txq->meta_pool, d_params);
     HOLOSCAN_LOG_CRITICAL("Failed to enqueue TX work");
     return;
   }
@@ -53,13 +53,15 @@ class AdvNetworkOpTx : public Operator {
  private:
     void SetFillInfo();
     Parameter<AdvNetConfigYaml> cfg_;
-    AdvNetworkOpTxImpl *impl;
+    AdvNetworkOpTxImpl *impl = nullptr;
 
     PacketLayerFill fill[MAX_INTERFACES][MAX_NUM_TX_QUEUES] = {FILL_NONE};
+    uint8_t  raw_eth_src_[MAX_INTERFACES][6];
     uint8_t  raw_eth_dst_[MAX_INTERFACES][MAX_NUM_TX_QUEUES][6];
     uint32_t raw_ip_src_[MAX_INTERFACES][MAX_NUM_TX_QUEUES];
     uint32_t raw_ip_dst_[MAX_INTERFACES][MAX_NUM_TX_QUEUES];
     uint16_t raw_udp_src_port_[MAX_INTERFACES][MAX_NUM_TX_QUEUES];
     uint16_t raw_udp_dst_port_[MAX_INTERFACES][MAX_NUM_TX_QUEUES];
+    bool hw_cksum_[MAX_INTERFACES] = {false};  // Port computes TX checksums itself
 };
 };  // namespace holoscan::ops
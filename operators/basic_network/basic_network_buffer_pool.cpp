@@ -0,0 +1,165 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <utility>
+#include "basic_network_buffer_pool.h"
+
+namespace holoscan::ops {
+
+NetworkBuffer::NetworkBuffer(const NetworkBuffer &other) : slot_(other.slot_) {
+  if (slot_ != nullptr) { slot_->refs.fetch_add(1, std::memory_order_relaxed); }
+}
+
+NetworkBuffer::NetworkBuffer(NetworkBuffer &&other) noexcept : slot_(other.slot_) {
+  other.slot_ = nullptr;
+}
+
+NetworkBuffer &NetworkBuffer::operator=(const NetworkBuffer &other) {
+  if (this != &other) {
+    reset();
+    slot_ = other.slot_;
+    if (slot_ != nullptr) { slot_->refs.fetch_add(1, std::memory_order_relaxed); }
+  }
+
+  return *this;
+}
+
+NetworkBuffer &NetworkBuffer::operator=(NetworkBuffer &&other) noexcept {
+  if (this != &other) {
+    reset();
+    slot_ = other.slot_;
+    other.slot_ = nullptr;
+  }
+
+  return *this;
+}
+
+void NetworkBuffer::reset() {
+  if (slot_ == nullptr) {
+    return;
+  }
+
+  if (slot_->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    // Hold the pool until the buffer is back in the free queue, since this may be the last
+    // reference keeping the pool alive.
+    auto pool = std::move(slot_->pool);
+    pool->Enqueue(slot_->index);
+  }
+
+  slot_ = nullptr;
+}
+
+std::shared_ptr<NetworkBufferPool> NetworkBufferPool::Create(uint32_t num_bufs,
+                                                             size_t buf_size) {
+  return std::make_shared<NetworkBufferPool>(num_bufs, buf_size);
+}
+
+NetworkBufferPool::NetworkBufferPool(uint32_t num_bufs, size_t buf_size)
+    : num_bufs_(num_bufs), buf_size_(buf_size) {
+  // The free queue is sized to the next power of two so it can never overflow
+  size_t queue_size = 1;
+  while (queue_size < num_bufs) { queue_size <<= 1; }
+  mask_ = queue_size - 1;
+
+  // Start every buffer on a cache line boundary
+  const size_t stride = (buf_size + CACHE_LINE_SIZE - 1) & ~(CACHE_LINE_SIZE - 1);
+  mem_ = std::make_unique<uint8_t[]>(stride * num_bufs + CACHE_LINE_SIZE);
+  auto base = reinterpret_cast<uintptr_t>(mem_.get());
+  base = (base + CACHE_LINE_SIZE - 1) & ~(CACHE_LINE_SIZE - 1);
+
+  slots_ = std::make_unique<NetworkBufferSlot[]>(num_bufs);
+  cells_ = std::make_unique<Cell[]>(queue_size);
+  for (size_t c = 0; c < queue_size; c++) {
+    cells_[c].seq.store(c, std::memory_order_relaxed);
+  }
+
+  for (uint32_t b = 0; b < num_bufs; b++) {
+    slots_[b].index = b;
+    slots_[b].data  = reinterpret_cast<uint8_t*>(base + b * stride);
+    Enqueue(b);
+  }
+}
+
+NetworkBuffer NetworkBufferPool::Get() {
+  uint32_t index;
+  if (!Dequeue(index)) {
+    exhausted_.fetch_add(1, std::memory_order_relaxed);
+    return NetworkBuffer();
+  }
+
+  auto &slot = slots_[index];
+  slot.refs.store(1, std::memory_order_relaxed);
+  slot.pool = shared_from_this();
+
+  return NetworkBuffer(&slot);
+}
+
+uint32_t NetworkBufferPool::Available() const {
+  auto enq = enqueue_pos_.load(std::memory_order_relaxed);
+  auto deq = dequeue_pos_.load(std::memory_order_relaxed);
+  return enq > deq ? static_cast<uint32_t>(enq - deq) : 0;
+}
+
+// Bounded MPMC queue from Dmitry Vyukov. Each cell's sequence number tells producers and
+// consumers whether the cell is ready for them, so no locks or CAS loops on shared data are needed
+// beyond claiming a position.
+void NetworkBufferPool::Enqueue(uint32_t index) {
+  auto pos = enqueue_pos_.load(std::memory_order_relaxed);
+  for (;;) {
+    auto &cell = cells_[pos & mask_];
+    auto seq   = cell.seq.load(std::memory_order_acquire);
+    auto diff  = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+    if (diff == 0) {
+      if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+        cell.index = index;
+        cell.seq.store(pos + 1, std::memory_order_release);
+        return;
+      }
+    } else {
+      // A slot is only ever returned once, so the queue cannot be full. The cell is still being
+      // read by a consumer; reload and retry.
+      pos = enqueue_pos_.load(std::memory_order_relaxed);
+    }
+  }
+}
+
+bool NetworkBufferPool::Dequeue(uint32_t &index) {
+  auto pos = dequeue_pos_.load(std::memory_order_relaxed);
+  for (;;) {
+    auto &cell = cells_[pos & mask_];
+    auto seq   = cell.seq.load(std::memory_order_acquire);
+    auto diff  = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+    if (diff == 0) {
+      if (dequeue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+        index = cell.index;
+        cell.seq.store(pos + mask_ + 1, std::memory_order_release);
+        return true;
+      }
+    } else if (diff < 0) {
+      // Only report empty if no producer has claimed this cell. Otherwise a buffer is in the
+      // middle of being returned and will be visible momentarily.
+      if (enqueue_pos_.load(std::memory_order_acquire) == pos) {
+        return false;
+      }
+      pos = dequeue_pos_.load(std::memory_order_relaxed);
+    } else {
+      pos = dequeue_pos_.load(std::memory_order_relaxed);
+    }
+  }
+}
+
+};  // namespace holoscan::ops
@@ -0,0 +1,132 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace holoscan::ops {
+
+class NetworkBufferPool;
+
+/**
+ * @brief Bookkeeping for a single buffer in a NetworkBufferPool
+ *
+ */
+struct NetworkBufferSlot {
+  std::atomic<uint32_t> refs{0};
+  uint32_t index = 0;
+  uint8_t *data = nullptr;
+  std::shared_ptr<NetworkBufferPool> pool;  // Keeps the pool alive while the buffer is handed out
+};
+
+/**
+ * @brief Reference-counted handle to a buffer owned by a NetworkBufferPool
+ *
+ * Copies of a handle share the same buffer. The buffer is returned to its pool when the last
+ * handle referencing it is destroyed or reset, so consumers never free buffers explicitly.
+ */
+class NetworkBuffer {
+ public:
+  NetworkBuffer() = default;
+  NetworkBuffer(const NetworkBuffer &other);
+  NetworkBuffer(NetworkBuffer &&other) noexcept;
+  NetworkBuffer &operator=(const NetworkBuffer &other);
+  NetworkBuffer &operator=(NetworkBuffer &&other) noexcept;
+  ~NetworkBuffer() { reset(); }
+
+  /**
+   * @brief Drop this handle's reference, returning the buffer to the pool if it was the last one
+   */
+  void reset();
+
+  uint8_t *data() const { return slot_ != nullptr ? slot_->data : nullptr; }
+  explicit operator bool() const { return slot_ != nullptr; }
+
+ private:
+  friend class NetworkBufferPool;
+  explicit NetworkBuffer(NetworkBufferSlot *slot) : slot_(slot) {}
+
+  NetworkBufferSlot *slot_ = nullptr;
+};
+
+/**
+ * @brief Fixed-capacity, lock-free pool of equally sized buffers
+ *
+ * All memory is allocated up front. Free buffers are tracked in a bounded multi-producer,
+ * multi-consumer queue so buffers can be taken and returned from any thread without locks.
+ * Pools must be created with Create() since outstanding buffers hold a reference to the pool.
+ */
+class NetworkBufferPool : public std::enable_shared_from_this<NetworkBufferPool> {
+ public:
+  /**
+   * @brief Create a pool
+   *
+   * @param num_bufs Number of buffers in the pool
+   * @param buf_size Size of each buffer in bytes
+   * @return Shared pointer to the pool
+   */
+  static std::shared_ptr<NetworkBufferPool> Create(uint32_t num_bufs, size_t buf_size);
+
+  NetworkBufferPool(uint32_t num_bufs, size_t buf_size);
+  NetworkBufferPool(const NetworkBufferPool &) = delete;
+  NetworkBufferPool &operator=(const NetworkBufferPool &) = delete;
+
+  /**
+   * @brief Take a free buffer from the pool
+   *
+   * @return Handle to the buffer, or an empty handle if the pool is exhausted
+   */
+  NetworkBuffer Get();
+
+  uint32_t Capacity() const { return num_bufs_; }
+  size_t BufferSize() const { return buf_size_; }
+  uint32_t Available() const;
+
+  /**
+   * @brief Number of times Get() failed because every buffer was in use
+   */
+  uint64_t NumExhausted() const { return exhausted_.load(std::memory_order_relaxed); }
+
+ private:
+  friend class NetworkBuffer;
+  static constexpr size_t CACHE_LINE_SIZE = 64;
+
+  struct Cell {
+    std::atomic<size_t> seq;
+    uint32_t index;
+  };
+
+  bool Dequeue(uint32_t &index);
+  void Enqueue(uint32_t index);
+
+  uint32_t num_bufs_;
+  size_t buf_size_;
+  size_t mask_;
+  std::unique_ptr<uint8_t[]> mem_;
+  std::unique_ptr<NetworkBufferSlot[]> slots_;
+  std::unique_ptr<Cell[]> cells_;
+  alignas(CACHE_LINE_SIZE) std::atomic<size_t> enqueue_pos_{0};
+  alignas(CACHE_LINE_SIZE) std::atomic<size_t> dequeue_pos_{0};
+  alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> exhausted_{0};
+};
+
+};  // namespace holoscan::ops
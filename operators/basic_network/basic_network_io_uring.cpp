@@ -0,0 +1,382 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <errno.h>
+#include <string.h>
+#include <algorithm>
+#include <utility>
+#include "basic_network_io_uring.h"
+#include "holoscan/holoscan.hpp"
+
+#ifdef BASIC_NETWORK_IO_URING
+#include <liburing.h>
+#endif
+
+namespace holoscan::ops {
+
+#ifdef BASIC_NETWORK_IO_URING
+
+// Provided buffer group used for receives. Each engine has its own ring, so one ID is enough.
+static constexpr int RX_BUF_GROUP = 0;
+
+// Completions reaped per io_uring_peek_batch_cqe() call
+static constexpr unsigned CQE_BATCH = 64;
+
+// Largest provided buffer ring the kernel accepts
+static constexpr uint32_t MAX_RX_BUFS = 32768;
+
+std::unique_ptr<NetworkUringRx> NetworkUringRx::Create(int sockfd,
+                                                       std::shared_ptr<NetworkBufferPool> pool,
+                                                       uint32_t num_slots, uint32_t slots_per_buf,
+                                                       uint16_t slot_size) {
+  if (slots_per_buf == 0 || slots_per_buf > MAX_RX_BUFS) {
+    HOLOSCAN_LOG_ERROR("io_uring receive needs between 1 and {} packets per burst", MAX_RX_BUFS);
+    return nullptr;
+  }
+
+  // The ring holds at least one whole buffer, so an empty pool leaves nothing to receive into
+  if (pool->Capacity() == 0) {
+    HOLOSCAN_LOG_CRITICAL("io_uring receive needs a buffer pool of at least one buffer");
+    return nullptr;
+  }
+
+  // Whole buffers are provided, and the buffer ID of every slot must fit in the ring
+  const uint32_t num_bufs = std::clamp((num_slots + slots_per_buf - 1) / slots_per_buf, 1U,
+                                       std::min(pool->Capacity(), MAX_RX_BUFS / slots_per_buf));
+
+  std::unique_ptr<NetworkUringRx> rx(new NetworkUringRx());
+  rx->sockfd_ = sockfd;
+  rx->pool_ = std::move(pool);
+  rx->slot_size_ = slot_size;
+  rx->slots_per_buf_ = slots_per_buf;
+  rx->ring_entries_ = 1;
+  while (rx->ring_entries_ < num_bufs * slots_per_buf) { rx->ring_entries_ <<= 1; }
+
+  // Only the multishot receive is ever submitted, so a tiny submission queue is enough. The
+  // completion queue holds a completion for every slot, plus the one the kernel posts when it
+  // ends the receive because the last slot was used.
+  struct io_uring_params params;
+  memset(&params, 0, sizeof(params));
+  params.flags = IORING_SETUP_CQSIZE;
+  params.cq_entries = rx->ring_entries_ * 2;
+
+  rx->ring_ = new struct io_uring;
+  int ret = io_uring_queue_init_params(4, rx->ring_, &params);
+  if (ret < 0) {
+    HOLOSCAN_LOG_ERROR("Failed to create io_uring for receive: {}", strerror(-ret));
+    delete rx->ring_;
+    rx->ring_ = nullptr;
+    return nullptr;
+  }
+
+  rx->buf_ring_ = io_uring_setup_buf_ring(rx->ring_, rx->ring_entries_, RX_BUF_GROUP, 0, &ret);
+  if (rx->buf_ring_ == nullptr) {
+    HOLOSCAN_LOG_ERROR("Failed to register io_uring receive buffers: {}", strerror(-ret));
+    return nullptr;
+  }
+
+  rx->bufs_.resize(num_bufs);
+  for (uint32_t b = 0; b < num_bufs; b++) {
+    rx->idle_.push_back(b);
+  }
+
+  rx->Replenish();
+  if (!rx->fill_order_.empty()) {
+    rx->Arm();
+  }
+
+  return rx;
+}
+
+NetworkUringRx::~NetworkUringRx() {
+  if (ring_ == nullptr) {
+    return;
+  }
+
+  // The kernel stops writing to the slots once the ring is gone, so the buffers can go back last
+  if (buf_ring_ != nullptr) {
+    io_uring_free_buf_ring(ring_, buf_ring_, ring_entries_, RX_BUF_GROUP);
+  }
+
+  io_uring_queue_exit(ring_);
+  delete ring_;
+}
+
+void NetworkUringRx::Replenish() {
+  const int mask = io_uring_buf_ring_mask(ring_entries_);
+  while (!idle_.empty()) {
+    const uint32_t b = idle_.back();
+    bufs_[b] = pool_->Get();
+    if (!bufs_[b]) {
+      return;
+    }
+
+    idle_.pop_back();
+    for (uint32_t slot = 0; slot < slots_per_buf_; slot++) {
+      io_uring_buf_ring_add(buf_ring_, bufs_[b].data() + slot * slot_size_, slot_size_,
+                            b * slots_per_buf_ + slot, mask, slot);
+    }
+
+    io_uring_buf_ring_advance(buf_ring_, slots_per_buf_);
+    fill_order_.push_back(b);
+  }
+}
+
+void NetworkUringRx::Arm() {
+  auto sqe = io_uring_get_sqe(ring_);
+  io_uring_prep_recv_multishot(sqe, sockfd_, nullptr, 0, 0);
+  sqe->flags |= IOSQE_BUFFER_SELECT;
+  sqe->buf_group = RX_BUF_GROUP;
+
+  int ret = io_uring_submit(ring_);
+  if (ret < 0) {
+    HOLOSCAN_LOG_ERROR("Failed to submit io_uring receive: {}", strerror(-ret));
+    return;
+  }
+
+  armed_ = true;
+  rearms_++;
+}
+
+bool NetworkUringRx::BeginBurst(NetworkBuffer &buf, uint32_t &first_slot) {
+  Replenish();
+  if (fill_order_.empty()) {
+    return false;
+  }
+
+  // A receive that ended for lack of slots resumes now that there are some
+  if (!armed_) {
+    Arm();
+  }
+
+  buf = bufs_[fill_order_.front()];
+  first_slot = fill_slot_;
+  burst_full_ = false;
+  return true;
+}
+
+uint32_t NetworkUringRx::Harvest(uint32_t *lens, uint32_t max_pkts, uint32_t &bytes) {
+  struct io_uring_cqe *cqes[CQE_BATCH];
+  uint32_t pkts = 0;
+
+  // Each completion with a buffer fills the next slot, so stopping at the end of the buffer keeps
+  // the rest of the completions for the next burst
+  while (!burst_full_ && pkts < max_pkts) {
+    const uint32_t want = std::min({max_pkts - pkts, slots_per_buf_ - fill_slot_, CQE_BATCH});
+    auto n = io_uring_peek_batch_cqe(ring_, cqes, want);
+    if (n == 0) {
+      break;
+    }
+
+    for (unsigned c = 0; c < n; c++) {
+      auto cqe = cqes[c];
+      if (!(cqe->flags & IORING_CQE_F_MORE)) {
+        armed_ = false;
+      }
+
+      if (cqe->res < 0 && cqe->res != -ENOBUFS) {
+        errors_++;
+        HOLOSCAN_LOG_ERROR("io_uring receive failed: {}", strerror(-cqe->res));
+      }
+
+      if (!(cqe->flags & IORING_CQE_F_BUFFER)) {
+        continue;
+      }
+
+      const uint32_t bid = cqe->flags >> IORING_CQE_BUFFER_SHIFT;
+      if (bid != fill_order_.front() * slots_per_buf_ + fill_slot_) {
+        errors_++;
+        HOLOSCAN_LOG_ERROR("io_uring receive used buffer {} out of order", bid);
+      }
+
+      lens[pkts++] = std::max(cqe->res, 0);
+      bytes += std::max(cqe->res, 0);
+      if (++fill_slot_ == slots_per_buf_) {
+        // Every slot has been filled, so only the bursts in this buffer still need it
+        bufs_[fill_order_.front()].reset();
+        idle_.push_back(fill_order_.front());
+        fill_order_.pop_front();
+        fill_slot_ = 0;
+        burst_full_ = true;
+      }
+    }
+
+    io_uring_cq_advance(ring_, n);
+  }
+
+  // The kernel ends a multishot receive when it runs out of slots or hits an error
+  Replenish();
+  if (!armed_ && !fill_order_.empty()) {
+    Arm();
+  }
+
+  return pkts;
+}
+
+int NetworkUringRx::PollFd() const {
+  return ring_->ring_fd;
+}
+
+std::unique_ptr<NetworkUringTx> NetworkUringTx::Create(int sockfd, uint32_t queue_depth) {
+  std::unique_ptr<NetworkUringTx> tx(new NetworkUringTx());
+  tx->sockfd_ = sockfd;
+  tx->queue_depth_ = queue_depth;
+
+  // The completion queue defaults to twice the submission queue, and sends in flight are capped
+  // at queue_depth, so it can never overflow
+  tx->ring_ = new struct io_uring;
+  int ret = io_uring_queue_init(queue_depth, tx->ring_, 0);
+  if (ret < 0) {
+    HOLOSCAN_LOG_ERROR("Failed to create io_uring for transmit: {}", strerror(-ret));
+    delete tx->ring_;
+    tx->ring_ = nullptr;
+    return nullptr;
+  }
+
+  return tx;
+}
+
+NetworkUringTx::~NetworkUringTx() {
+  if (ring_ == nullptr) {
+    return;
+  }
+
+  Drain();
+  io_uring_queue_exit(ring_);
+  delete ring_;
+}
+
+void NetworkUringTx::Send(std::shared_ptr<NetworkOpBurstParams> msg, uint32_t send_size,
+                          uint32_t pkt_size) {
+  Harvest();
+
+  // Count every send up front so the burst cannot be released while it is still being queued
+  const uint32_t num_sends = (msg->len + send_size - 1) / send_size;
+  if (num_sends == 0) {
+    return;
+  }
+
+  const uint64_t seq = next_seq_++;
+  bursts_.push_back({msg, num_sends});
+
+  for (uint32_t s = 0; s < num_sends; s++) {
+    if (sends_in_flight_ == queue_depth_) {
+      submits_++;
+      io_uring_submit_and_wait(ring_, 1);
+      Harvest();
+    }
+
+    auto sqe = io_uring_get_sqe(ring_);
+    if (sqe == nullptr) {
+      submits_++;
+      io_uring_submit(ring_);
+      sqe = io_uring_get_sqe(ring_);
+    }
+
+    const uint32_t len = std::min(send_size, msg->len - s * send_size);
+    const uint32_t pkts = (len + pkt_size - 1) / pkt_size;
+    io_uring_prep_send(sqe, sockfd_, msg->data + s * send_size, len, 0);
+
+    // The low byte carries the packets in this send so completions can be counted as packets
+    io_uring_sqe_set_data64(sqe, (seq << 8) | pkts);
+    sends_in_flight_++;
+  }
+
+  submits_++;
+  int ret = io_uring_submit(ring_);
+  if (ret < 0) {
+    HOLOSCAN_LOG_ERROR("Failed to submit io_uring sends: {}", strerror(-ret));
+  }
+}
+
+void NetworkUringTx::Harvest() {
+  struct io_uring_cqe *cqes[CQE_BATCH];
+  unsigned n;
+
+  while ((n = io_uring_peek_batch_cqe(ring_, cqes, CQE_BATCH)) > 0) {
+    for (unsigned c = 0; c < n; c++) {
+      const auto data = io_uring_cqe_get_data64(cqes[c]);
+      const auto pkts = data & 0xff;
+      bursts_[(data >> 8) - front_seq_].remaining--;
+
+      if (cqes[c]->res < 0) {
+        pkts_failed_ += pkts;
+        HOLOSCAN_LOG_ERROR("io_uring send failed: {}", strerror(-cqes[c]->res));
+      } else {
+        pkts_sent_ += pkts;
+      }
+    }
+
+    io_uring_cq_advance(ring_, n);
+    sends_in_flight_ -= n;
+  }
+
+  while (!bursts_.empty() && bursts_.front().remaining == 0) {
+    bursts_.pop_front();
+    front_seq_++;
+  }
+}
+
+void NetworkUringTx::Drain() {
+  while (sends_in_flight_ > 0) {
+    struct io_uring_cqe *cqe;
+    if (io_uring_wait_cqe(ring_, &cqe) < 0) {
+      return;
+    }
+
+    Harvest();
+  }
+}
+
+#else
+
+std::unique_ptr<NetworkUringRx> NetworkUringRx::Create(int, std::shared_ptr<NetworkBufferPool>,
+                                                       uint32_t, uint32_t, uint16_t) {
+  HOLOSCAN_LOG_ERROR("Basic network operators were built without io_uring support");
+  return nullptr;
+}
+
+NetworkUringRx::~NetworkUringRx() {}
+
+bool NetworkUringRx::BeginBurst(NetworkBuffer &, uint32_t &) {
+  return false;
+}
+
+uint32_t NetworkUringRx::Harvest(uint32_t *, uint32_t, uint32_t &) {
+  return 0;
+}
+
+int NetworkUringRx::PollFd() const {
+  return -1;
+}
+
+std::unique_ptr<NetworkUringTx> NetworkUringTx::Create(int, uint32_t) {
+  HOLOSCAN_LOG_ERROR("Basic network operators were built without io_uring support");
+  return nullptr;
+}
+
+NetworkUringTx::~NetworkUringTx() {}
+
+void NetworkUringTx::Send(std::shared_ptr<NetworkOpBurstParams>, uint32_t, uint32_t) {}
+
+void NetworkUringTx::Harvest() {}
+
+void NetworkUringTx::Drain() {}
+
+#endif
+
+};  // namespace holoscan::ops
@@ -0,0 +1,189 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <deque>
+#include <memory>
+#include <vector>
+#include "basic_network_operator_common.h"
+
+// liburing types are kept out of this header so it can be included whether or not the operators
+// were built with io_uring support
+struct io_uring;
+struct io_uring_buf_ring;
+
+namespace holoscan::ops {
+
+/**
+ * @brief io_uring receive engine for a single socket
+ *
+ * Keeps one multishot receive armed on the socket. Packets are received straight into the
+ * operator's burst buffers: each buffer taken from its NetworkBufferPool is split into one
+ * slot_size slot per packet, and every slot is added to a provided buffer ring. The kernel uses
+ * ring entries in the order they were added, so a buffer's slots fill in order and a burst is a
+ * run of consecutive slots in one buffer, emitted without copying. The engine holds each buffer
+ * until the kernel has filled all of its slots, then takes a fresh one from the pool. Harvest()
+ * drains completions from the shared completion queue without a system call. A system call is
+ * only made when the kernel ends the multishot receive, for example after running out of slots,
+ * and it must be re-armed.
+ */
+class NetworkUringRx {
+ public:
+  /**
+   * @brief Create a receive engine
+   *
+   * @param sockfd Bound UDP socket or connected TCP socket to receive on
+   * @param pool Pool the burst buffers come from
+   * @param num_slots Slots to keep provided to the kernel. Rounded up to whole buffers
+   * @param slots_per_buf Slots at the start of each buffer, normally the batch size
+   * @param slot_size Size of each slot, normally the maximum payload size
+   * @return The engine, or nullptr if io_uring is unavailable
+   */
+  static std::unique_ptr<NetworkUringRx> Create(int sockfd, std::shared_ptr<NetworkBufferPool> pool,
+                                                uint32_t num_slots, uint32_t slots_per_buf,
+                                                uint16_t slot_size);
+  ~NetworkUringRx();
+
+  NetworkUringRx(const NetworkUringRx &) = delete;
+  NetworkUringRx &operator=(const NetworkUringRx &) = delete;
+
+  /**
+   * @brief Start a burst at the next slot the kernel will fill
+   *
+   * @param buf Set to the buffer holding the burst's packets
+   * @param first_slot Set to the slot of the burst's first packet. Packet i of the burst is in
+   * slot first_slot + i
+   * @return false if every pool buffer is in use, so no slots are provided to the kernel
+   */
+  bool BeginBurst(NetworkBuffer &buf, uint32_t &first_slot);
+
+  /**
+   * @brief Add received packets to the current burst
+   *
+   * Stops at the end of the burst's buffer, after which BurstFull() is true and a new burst must
+   * be started.
+   *
+   * @param lens Destination for the length of each packet
+   * @param max_pkts Most packets to add
+   * @param bytes Incremented by the number of bytes received
+   * @return Number of packets added
+   */
+  uint32_t Harvest(uint32_t *lens, uint32_t max_pkts, uint32_t &bytes);
+
+  /**
+   * @brief Whether the current burst reached the end of its buffer
+   */
+  bool BurstFull() const { return burst_full_; }
+
+  /**
+   * @brief File descriptor that polls readable while completions are waiting to be harvested
+   */
+  int PollFd() const;
+
+  uint64_t NumRearms() const { return rearms_; }
+  uint64_t NumErrors() const { return errors_; }
+
+ private:
+  NetworkUringRx() = default;
+  void Replenish();
+  void Arm();
+
+  int sockfd_ = -1;
+  uint16_t slot_size_ = 0;
+  uint32_t slots_per_buf_ = 0;
+  uint32_t ring_entries_ = 0;
+  struct io_uring *ring_ = nullptr;
+  struct io_uring_buf_ring *buf_ring_ = nullptr;
+  std::shared_ptr<NetworkBufferPool> pool_;
+  std::vector<NetworkBuffer> bufs_;  // Buffers with slots in the ring. Buffer ID / slots_per_buf_
+  std::vector<uint32_t> idle_;       // Entries of bufs_ waiting for a free pool buffer
+  std::deque<uint32_t> fill_order_;  // Entries of bufs_ in the order the kernel fills them
+  uint32_t fill_slot_ = 0;           // Next slot of fill_order_.front() the kernel fills
+  bool burst_full_ = false;
+  bool armed_ = false;
+  uint64_t rearms_ = 0;
+  uint64_t errors_ = 0;
+};
+
+/**
+ * @brief io_uring transmit engine for a single connected socket
+ *
+ * Each burst is split into sends that are all queued with a single submission. Bursts stay
+ * referenced until every one of their sends has completed, and completions are reaped in bulk on
+ * the next call, so the operator never waits on the network.
+ */
+class NetworkUringTx {
+ public:
+  /**
+   * @brief Create a transmit engine
+   *
+   * @param sockfd Connected socket to send on
+   * @param queue_depth Most sends that may be in flight at once
+   * @return The engine, or nullptr if io_uring is unavailable
+   */
+  static std::unique_ptr<NetworkUringTx> Create(int sockfd, uint32_t queue_depth);
+  ~NetworkUringTx();
+
+  NetworkUringTx(const NetworkUringTx &) = delete;
+  NetworkUringTx &operator=(const NetworkUringTx &) = delete;
+
+  /**
+   * @brief Queue a burst for transmission
+   *
+   * @param msg Burst to send
+   * @param send_size Bytes per send. The last send of a burst may be shorter
+   * @param pkt_size Bytes per packet, used to count packets when a send carries several segments
+   */
+  void Send(std::shared_ptr<NetworkOpBurstParams> msg, uint32_t send_size, uint32_t pkt_size);
+
+  /**
+   * @brief Reap completed sends and release bursts that are fully sent
+   */
+  void Harvest();
+
+  /**
+   * @brief Wait for every queued send to complete
+   */
+  void Drain();
+
+  uint64_t NumPktsSent() const { return pkts_sent_; }
+  uint64_t NumPktsFailed() const { return pkts_failed_; }
+  uint64_t NumSubmits() const { return submits_; }
+
+ private:
+  struct InFlightBurst {
+    std::shared_ptr<NetworkOpBurstParams> msg;
+    uint32_t remaining;  // Sends not yet completed
+  };
+
+  NetworkUringTx() = default;
+
+  int sockfd_ = -1;
+  uint32_t queue_depth_ = 0;
+  uint32_t sends_in_flight_ = 0;
+  struct io_uring *ring_ = nullptr;
+  std::deque<InFlightBurst> bursts_;
+  uint64_t front_seq_ = 0;  // Sequence number of bursts_.front()
+  uint64_t next_seq_ = 0;
+  uint64_t pkts_sent_ = 0;
+  uint64_t pkts_failed_ = 0;
+  uint64_t submits_ = 0;
+};
+
+};  // namespace holoscan::ops
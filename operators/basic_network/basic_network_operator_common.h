@@ -16,15 +16,126 @@
 
 #pragma once
 
+#include <stdint.h>
+#include <utility>
+#include "basic_network_buffer_pool.h"
+
 enum class L4Proto {
   TCP,
   UDP
 };
 
+/**
+ * @brief Socket receive mode used by the RX operator
+ *
+ * SINGLE issues one recvfrom() per datagram. BATCH pulls up to a full batch of datagrams
+ * with a single recvmmsg() call, which greatly reduces syscall overhead at high packet rates.
+ */
+enum class RecvMode {
+  SINGLE,
+  BATCH
+};
+
+/**
+ * @brief Message framing used on TCP streams
+ *
+ * NONE treats whatever each read returns as a packet, so packet boundaries depend on how TCP
+ * segmented the stream. LENGTH_PREFIX precedes every message with a 32-bit big-endian length so the
+ * receiver restores the sender's message boundaries.
+ */
+enum class Framing {
+  NONE,
+  LENGTH_PREFIX
+};
+
+// Size of the length header before each message with Framing::LENGTH_PREFIX
+constexpr uint32_t FRAME_HDR_SIZE = sizeof(uint32_t);
+
+/**
+ * @brief I/O engine used by the basic network operators
+ *
+ * SOCKET uses non-blocking socket calls from the operator thread. IO_URING keeps receives and sends
+ * in flight in an io_uring and reaps their completions in bulk from compute().
+ */
+enum class IoBackend {
+  SOCKET,
+  IO_URING
+};
+
+/**
+ * @brief Socket transmit mode used by the TX operator
+ *
+ * SINGLE issues one sendto() per packet. BATCH submits every packet in a burst with sendmmsg().
+ * GSO also uses sendmmsg(), but each message is a UDP_SEGMENT super-datagram that the kernel splits
+ * into packets, so a burst crosses the stack as a handful of large sends.
+ */
+enum class TxMode {
+  SINGLE,
+  BATCH,
+  GSO
+};
+
+/**
+ * @brief How the TX operator enforces the minimum inter-packet gap
+ *
+ * SLEEP calls nanosleep() after every packet. TXTIME stamps each datagram with a launch time using
+ * SO_TXTIME so the kernel qdisc (fq or etf) releases packets on schedule, letting a whole burst be
+ * queued at once. TOKEN_BUCKET paces in user space by sending as many packets as the bucket holds.
+ */
+enum class PacingMode {
+  SLEEP,
+  TXTIME,
+  TOKEN_BUCKET
+};
+
+/**
+ * @brief Action taken by the RX operator when its buffer pool has no free buffers
+ *
+ * BACKPRESSURE stops reading the socket until a buffer is returned, leaving packets queued in the
+ * kernel. DROP keeps draining the socket and discards packets so the kernel queue never backs up.
+ */
+enum class PoolFullPolicy {
+  BACKPRESSURE,
+  DROP
+};
+
+/**
+ * @brief Per-packet receive timestamps recorded by the RX operator
+ *
+ * SOFTWARE stamps packets with CLOCK_REALTIME as the kernel receives them. HARDWARE uses the time
+ * the NIC received them, taken from its PTP hardware clock, which must be synchronized to the
+ * system clock (for example with phc2sys) to compare against CLOCK_REALTIME.
+ */
+enum class RxTimestampMode {
+  NONE,
+  SOFTWARE,
+  HARDWARE
+};
+
+/**
+ * @brief A burst of packets passed to or from the basic network operators
+ *
+ * Bursts built from a NetworkBuffer own their memory: the buffer goes back to its pool once the
+ * last copy of the burst is destroyed. Bursts built from a raw pointer do not own it, and the
+ * producer must keep the memory valid until the burst has been consumed. Packets are packed back
+ * to back unless pkt_stride is set, in which case packet i starts at data + i * pkt_stride and len
+ * is the sum of pkt_lens.
+ */
 struct NetworkOpBurstParams {
   NetworkOpBurstParams(uint8_t *data, uint32_t len, uint32_t num_pkts) :
     data(data), len(len), num_pkts(num_pkts) {}
+  NetworkOpBurstParams(uint8_t *data, uint32_t len, uint32_t num_pkts, uint32_t *pkt_lens) :
+    data(data), len(len), num_pkts(num_pkts), pkt_lens(pkt_lens) {}
+  NetworkOpBurstParams(holoscan::ops::NetworkBuffer buffer, uint32_t len, uint32_t num_pkts,
+                       uint32_t *pkt_lens = nullptr) :
+    data(buffer.data()), len(len), num_pkts(num_pkts), pkt_lens(pkt_lens),
+    buf(std::move(buffer)) {}
   uint8_t *data;
   uint32_t len;
   uint32_t num_pkts;
+  uint32_t *pkt_lens = nullptr;  // Length of each packet in data. Lives in the data allocation
+  uint32_t pkt_stride = 0;       // Distance between packet starts in data. 0 when packed
+  uint64_t *pkt_ts = nullptr;    // Receive time of each packet in ns. Lives in the data allocation
+  uint64_t emit_ts = 0;          // CLOCK_REALTIME time in ns the burst was emitted, if stamped
+  holoscan::ops::NetworkBuffer buf;  // Owner of data when it came from a buffer pool
 };
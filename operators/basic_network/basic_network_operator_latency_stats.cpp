@@ -0,0 +1,132 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023 NVIDIA CORPORATION & AFFILIATES. All rights reserved. * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <algorithm>
+#include <string>
+#include "basic_network_operator_latency_stats.h"
+#include "basic_network_rx_timestamp.h"
+
+namespace holoscan::ops {
+
+void NetworkLatencyHistogram::Add(uint64_t ns) {
+  buckets_[ns == 0 ? 0 : 63 - __builtin_clzll(ns)]++;
+  count_++;
+  sum_ += ns;
+  min_ = std::min(min_, ns);
+  max_ = std::max(max_, ns);
+}
+
+uint64_t NetworkLatencyHistogram::Percentile(double pct) const {
+  if (count_ == 0) {
+    return 0;
+  }
+
+  const auto rank = static_cast<uint64_t>(pct / 100.0 * count_);
+  uint64_t seen = 0;
+  for (int b = 0; b < NUM_BUCKETS; b++) {
+    seen += buckets_[b];
+    if (seen > rank || seen == count_) {
+      return (b == NUM_BUCKETS - 1) ? max_ : std::min<uint64_t>(max_, 2ULL << b);
+    }
+  }
+
+  return max_;
+}
+
+void NetworkLatencyHistogram::Log(const std::string &name) const {
+  if (count_ == 0) {
+    HOLOSCAN_LOG_INFO("{}: no samples", name);
+    return;
+  }
+
+  HOLOSCAN_LOG_INFO("{}: {} packets, min {:.1f} us, mean {:.1f} us, max {:.1f} us, "
+                    "p50 < {:.1f} us, p99 < {:.1f} us, p99.9 < {:.1f} us", name, count_, min_ / 1e3,
+                    static_cast<double>(sum_) / count_ / 1e3, max_ / 1e3, Percentile(50) / 1e3,
+                    Percentile(99) / 1e3, Percentile(99.9) / 1e3);
+
+  for (int b = 0; b < NUM_BUCKETS; b++) {
+    if (buckets_[b] > 0) {
+      HOLOSCAN_LOG_INFO("  [{:>10.1f}, {:>10.1f}) us: {:>12} ({:.3f}%)", (1ULL << b) / 1e3,
+                        (2ULL << b) / 1e3, buckets_[b], 100.0 * buckets_[b] / count_);
+    }
+  }
+}
+
+void BasicNetworkOpLatencyStats::setup(OperatorSpec& spec) {
+  spec.input<NetworkOpBurstParams>("burst_in");
+
+  spec.param<uint32_t>(report_interval_s_,
+                       "report_interval_s",
+                       "Report interval",
+                       "Seconds between latency reports. 0 reports only at shutdown",
+                       0);
+}
+
+BasicNetworkOpLatencyStats::~BasicNetworkOpLatencyStats() {
+  Report();
+}
+
+void BasicNetworkOpLatencyStats::Report() const {
+  HOLOSCAN_LOG_INFO("Latency stats over {} bursts", bursts_);
+  if (unstamped_bursts_ > 0) {
+    HOLOSCAN_LOG_WARN("{} bursts had no receive timestamps; set rx_timestamps on the RX operator",
+                      unstamped_bursts_);
+  }
+
+  if (skewed_pkts_ > 0) {
+    HOLOSCAN_LOG_WARN("{} packets were stamped in the future; is the NIC clock synchronized?",
+                      skewed_pkts_);
+  }
+
+  rx_to_emit_.Log("Receive to emit");
+  rx_to_downstream_.Log("Receive to downstream");
+}
+
+void BasicNetworkOpLatencyStats::compute(InputContext& op_input,
+                                         [[maybe_unused]] OutputContext&,
+                                         [[maybe_unused]] ExecutionContext&) {
+  auto burst = op_input.receive<NetworkOpBurstParams>("burst_in");
+  const uint64_t now = RealtimeNs();
+  bursts_++;
+
+  if (burst->pkt_ts == nullptr) {
+    unstamped_bursts_++;
+    return;
+  }
+
+  for (uint32_t p = 0; p < burst->num_pkts; p++) {
+    const uint64_t ts = burst->pkt_ts[p];
+    if (ts > burst->emit_ts) {
+      skewed_pkts_++;
+      continue;
+    }
+
+    rx_to_emit_.Add(burst->emit_ts - ts);
+    rx_to_downstream_.Add(now - ts);
+  }
+
+  if (report_interval_s_.get() > 0) {
+    if (last_report_ns_ == 0) {
+      last_report_ns_ = now;
+    } else if (now - last_report_ns_ >= report_interval_s_.get() * 1000000000ULL) {
+      Report();
+      last_report_ns_ = now;
+    }
+  }
+}
+
+};  // namespace holoscan::ops
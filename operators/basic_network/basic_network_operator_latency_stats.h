@@ -0,0 +1,95 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023 NVIDIA CORPORATION & AFFILIATES. All rights reserved. * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include <stdint.h>
+#include <string>
+#include "basic_network_operator_common.h"
+#include "holoscan/holoscan.hpp"
+
+namespace holoscan::ops {
+
+/**
+ * @brief Latency histogram with power-of-two nanosecond buckets
+ *
+ * Bucket b counts latencies in [2^b, 2^(b+1)) ns, so percentiles are accurate to within a factor
+ * of two while adding a sample costs a single bit scan.
+ */
+class NetworkLatencyHistogram {
+ public:
+  static constexpr int NUM_BUCKETS = 64;
+
+  void Add(uint64_t ns);
+
+  /**
+   * @brief Upper bound of the bucket holding the given percentile, capped at the largest sample
+   *
+   * @param pct Percentile between 0 and 100
+   * @return Latency in nanoseconds, or 0 if there are no samples
+   */
+  uint64_t Percentile(double pct) const;
+
+  /**
+   * @brief Log a summary line followed by one line per non-empty bucket
+   *
+   * @param name Name of the latency being reported
+   */
+  void Log(const std::string &name) const;
+
+  uint64_t Count() const { return count_; }
+
+ private:
+  uint64_t buckets_[NUM_BUCKETS] = {};
+  uint64_t count_ = 0;
+  uint64_t sum_ = 0;
+  uint64_t min_ = UINT64_MAX;
+  uint64_t max_ = 0;
+};
+
+/**
+ * @brief Reports how long received packets took to reach the pipeline
+ *
+ * Consumes bursts from BasicNetworkOpRx with rx_timestamps enabled. Receive-to-emit is the time
+ * from each packet's receive timestamp until the RX operator emitted its burst, and
+ * receive-to-downstream is the time until the burst arrived at this operator. Both are measured
+ * against CLOCK_REALTIME, so hardware timestamps are only meaningful when the NIC clock is
+ * synchronized to it.
+ */
+class BasicNetworkOpLatencyStats : public Operator {
+ public:
+  HOLOSCAN_OPERATOR_FORWARD_ARGS(BasicNetworkOpLatencyStats);
+
+  BasicNetworkOpLatencyStats() = default;
+  ~BasicNetworkOpLatencyStats();
+  void setup(OperatorSpec& spec) override;
+  void compute(InputContext& op_input, OutputContext&, ExecutionContext&) override;
+
+ private:
+  void Report() const;
+
+  Parameter<uint32_t> report_interval_s_;
+
+  NetworkLatencyHistogram rx_to_emit_;
+  NetworkLatencyHistogram rx_to_downstream_;
+  uint64_t bursts_ = 0;
+  uint64_t unstamped_bursts_ = 0;  // Bursts that arrived without receive timestamps
+  uint64_t skewed_pkts_ = 0;       // Packets stamped later than they were emitted or consumed
+  uint64_t last_report_ns_ = 0;
+};
+
+};  // namespace holoscan::ops
@@ -14,13 +14,29 @@
  * limitations under the License.
  */
 
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/uio.h>
+#include <time.h>
+#include <unistd.h>
+#include <algorithm>
 #include <memory>
 #include <string>
+#include <utility>
 
 #include "basic_network_operator_rx.h"
 
 namespace holoscan::ops {
 
+static uint64_t NowNs() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + ts.tv_nsec;
+}
+
 void BasicNetworkOpRx::setup(OperatorSpec& spec) {
   spec.output<NetworkOpBurstParams>("burst_out");
 
@@ -31,10 +47,116 @@ void BasicNetworkOpRx::setup(OperatorSpec& spec) {
   spec.param<uint32_t>(batch_size_, "batch_size", "Batch size", "Number of packets in batch");
   spec.param<uint16_t>(
       max_payload_size_, "max_payload_size", "Max payload size", "Largest payload size");
+  spec.param<std::string>(recv_mode_p_,
+                          "recv_mode",
+                          "UDP receive mode",
+                          "single (one recvfrom per packet) or batch (recvmmsg per batch)",
+                          "single");
+  spec.param<uint32_t>(buffer_pool_size_,
+                       "buffer_pool_size",
+                       "Buffer pool size",
+                       "Number of burst buffers that may be in flight downstream at once",
+                       16);
+  spec.param<std::string>(pool_full_policy_p_,
+                          "pool_full_policy",
+                          "Pool full policy",
+                          "backpressure (stop reading) or drop (discard packets) when no buffers "
+                          "are free",
+                          "backpressure");
+  spec.param<uint32_t>(num_shards_,
+                       "num_shards",
+                       "Number of RX shards",
+                       "UDP sockets bound with SO_REUSEPORT, each drained by its own thread. "
+                       "0 receives on the operator thread",
+                       0);
+  spec.param<std::vector<int>>(shard_cpus_,
+                               "shard_cpus",
+                               "Shard CPUs",
+                               "CPU to pin each shard's worker thread to",
+                               {});
+  spec.param<uint32_t>(shard_ring_size_,
+                       "shard_ring_size",
+                       "Shard ring size",
+                       "Packets buffered between each shard's worker and the operator",
+                       4096);
+  spec.param<std::string>(io_backend_p_,
+                          "io_backend",
+                          "I/O backend",
+                          "socket (non-blocking socket calls) or io_uring (multishot receive)",
+                          "socket");
+  spec.param<uint32_t>(io_uring_entries_,
+                       "io_uring_entries",
+                       "io_uring receive buffers",
+                       "Number of packet buffers provided to the io_uring multishot receive",
+                       1024);
+  spec.param<std::string>(framing_p_,
+                          "framing",
+                          "TCP message framing",
+                          "none (each read is a packet) or length_prefix (32-bit length before "
+                          "each message)",
+                          "none");
+  spec.param<uint32_t>(poll_timeout_ms_,
+                       "poll_timeout_ms",
+                       "Receive wait timeout",
+                       "Longest time compute() blocks waiting for packets. 0 returns immediately",
+                       0);
+  spec.param<uint32_t>(max_batch_latency_us_,
+                       "max_batch_latency_us",
+                       "Maximum batch latency",
+                       "Emit a partial batch once its first packet is this old. 0 waits for a "
+                       "full batch",
+                       0);
+  spec.param<bool>(adaptive_batch_,
+                   "adaptive_batch",
+                   "Adaptive batching",
+                   "Size batches to the packets expected within max_batch_latency_us",
+                   false);
+  spec.param<uint32_t>(min_batch_size_,
+                       "min_batch_size",
+                       "Minimum adaptive batch size",
+                       "Smallest batch adaptive batching may choose",
+                       1);
+  spec.param<std::string>(rx_timestamps_p_,
+                          "rx_timestamps",
+                          "Receive timestamps",
+                          "none, software (kernel SO_TIMESTAMPNS) or hardware (NIC "
+                          "SO_TIMESTAMPING) receive time of each packet",
+                          "none");
 }
 
 BasicNetworkOpRx::~BasicNetworkOpRx() {
   HOLOSCAN_LOG_INFO("{} packets left in buffer for RX operator", pkts_in_batch_);
+
+  if (pool_ != nullptr) {
+    HOLOSCAN_LOG_INFO("RX buffer pool ran dry {} times, {} packets dropped",
+                      pool_empty_cnt_, dropped_pkts_);
+  }
+
+  if (uring_rx_ != nullptr) {
+    HOLOSCAN_LOG_INFO("io_uring receive was armed {} times with {} errors",
+                      uring_rx_->NumRearms(), uring_rx_->NumErrors());
+  }
+
+  for (const auto &stats : GetShardStats()) {
+    HOLOSCAN_LOG_INFO("RX shard {} (CPU {}): {} packets, {} bytes, {} recvmmsg calls, ring full {} "
+                      "times", stats.id, stats.cpu, stats.pkts, stats.bytes, stats.recv_calls,
+                      stats.ring_full);
+  }
+
+  if (max_batch_latency_us_.get() > 0) {
+    HOLOSCAN_LOG_INFO("RX operator emitted {} partial batches after max_batch_latency_us, final "
+                      "batch size {}", partial_flushes_, batch_target_);
+  }
+
+  if (epfd_ >= 0) {
+    HOLOSCAN_LOG_INFO("RX operator waited for packets {} times, {} timed out",
+                      poll_waits_, poll_timeouts_);
+
+    // Stop the shard workers before closing the eventfd they signal
+    shards_.clear();
+    if (wake_fd_ >= 0) { close(wake_fd_); }
+    close(epfd_);
+  }
 }
 
 void BasicNetworkOpRx::initialize() {
@@ -51,16 +173,139 @@ void BasicNetworkOpRx::initialize() {
   server_addr_.sin_family = AF_INET;
   server_addr_.sin_port = htons(port_.get());
 
-  if (l4_proto_p_.get() == "udp") {
-    l4_proto_ = L4Proto::UDP;
+  l4_proto_ = (l4_proto_p_.get() == "udp") ? L4Proto::UDP : L4Proto::TCP;
+
+  if (rx_timestamps_p_.get() == "hardware") {
+    ts_mode_ = RxTimestampMode::HARDWARE;
+  } else if (rx_timestamps_p_.get() == "software") {
+    ts_mode_ = RxTimestampMode::SOFTWARE;
+  }
+
+  if (num_shards_.get() > 0) {
+    // Shards bind their own sockets in place of the single operator socket
+    if (l4_proto_ != L4Proto::UDP) {
+      HOLOSCAN_LOG_CRITICAL("Sharded receive is only supported for UDP");
+      throw;
+    }
+  } else {
+    InitSocket();
+  }
+
+  if (recv_mode_p_.get() == "batch") {
+    if (l4_proto_ != L4Proto::UDP) {
+      HOLOSCAN_LOG_CRITICAL("Batch receive mode is only supported for UDP");
+      throw;
+    }
+
+    recv_mode_ = RecvMode::BATCH;
+
+    // Every descriptor gets its own iovec. Only the iovec base pointers change per batch.
+    msgs_.resize(batch_size_.get());
+    iovs_.resize(batch_size_.get());
+    for (uint32_t i = 0; i < batch_size_.get(); i++) {
+      iovs_[i].iov_len = max_payload_size_.get();
+      memset(&msgs_[i], 0, sizeof(msgs_[i]));
+      msgs_[i].msg_hdr.msg_iov = &iovs_[i];
+      msgs_[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    HOLOSCAN_LOG_INFO("Network RX operator using recvmmsg with up to {} packets per call",
+                      batch_size_.get());
+  } else {
+    recv_mode_ = RecvMode::SINGLE;
+  }
+
+  if (pool_full_policy_p_.get() == "drop") {
+    // TCP is a byte stream, so dropping part of it would corrupt everything after the gap
+    if (l4_proto_ != L4Proto::UDP) {
+      HOLOSCAN_LOG_CRITICAL("Drop pool full policy is only supported for UDP");
+      throw;
+    }
+
+    pool_full_policy_ = PoolFullPolicy::DROP;
+    drop_buf_.resize(max_payload_size_.get());
+  } else {
+    pool_full_policy_ = PoolFullPolicy::BACKPRESSURE;
+  }
+
+  // Packet lengths are stored after the payload area in the same buffer, followed by the receive
+  // timestamps when they are enabled
+  pkt_lens_offset_ = static_cast<size_t>(max_payload_size_.get()) * batch_size_.get();
+  pkt_lens_offset_ = (pkt_lens_offset_ + alignof(uint32_t) - 1) & ~(alignof(uint32_t) - 1);
+  pkt_ts_offset_ = pkt_lens_offset_ + sizeof(uint32_t) * batch_size_.get();
+  size_t buf_size = pkt_ts_offset_;
+  if (ts_mode_ != RxTimestampMode::NONE) {
+    pkt_ts_offset_ = (pkt_ts_offset_ + alignof(uint64_t) - 1) & ~(alignof(uint64_t) - 1);
+    buf_size = pkt_ts_offset_ + sizeof(uint64_t) * batch_size_.get();
+  }
+
+  pool_ = NetworkBufferPool::Create(buffer_pool_size_.get(), buf_size);
+  HOLOSCAN_LOG_INFO("Network RX operator using a pool of {} buffers of {} bytes",
+                    pool_->Capacity(), pool_->BufferSize());
+
+  if (framing_p_.get() == "length_prefix") {
+    if (l4_proto_ != L4Proto::TCP) {
+      HOLOSCAN_LOG_CRITICAL("Length-prefixed framing is only supported for TCP");
+      throw;
+    }
+
+    framing_ = Framing::LENGTH_PREFIX;
+    next_frame_len_ = max_payload_size_.get();
+
+    // A header and a payload for every message in a batch, plus the rest of a partial header
+    const size_t max_iovs = std::min<size_t>(2 * batch_size_.get() + 1, IOV_MAX);
+    frame_iovs_.resize(max_iovs);
+    frame_hdrs_.resize(max_iovs * FRAME_HDR_SIZE);
+  }
+
+  if (io_backend_p_.get() == "io_uring") {
+    if (framing_ == Framing::LENGTH_PREFIX) {
+      HOLOSCAN_LOG_WARN("io_uring does not support length-prefixed framing; using socket receive");
+    } else {
+      io_backend_ = IoBackend::IO_URING;
+    }
+  }
+
+  if (num_shards_.get() > 0) {
+    if (io_backend_ == IoBackend::IO_URING) {
+      HOLOSCAN_LOG_WARN("io_uring is not supported with sharded receive; shards use sockets");
+      io_backend_ = IoBackend::SOCKET;
+    }
+
+    InitShards();
+  } else if (io_backend_ == IoBackend::IO_URING && l4_proto_ == L4Proto::UDP) {
+    // TCP receives on the accepted socket, so its engine is created once a client connects
+    InitUring(sockfd_);
+  }
+
+  if (ts_mode_ != RxTimestampMode::NONE) {
+    InitTimestamps();
+  }
+
+  if (poll_timeout_ms_.get() > 0) {
+    InitPoll();
+  }
+
+  batch_target_ = batch_size_.get();
+  if (adaptive_batch_.get()) {
+    if (max_batch_latency_us_.get() == 0) {
+      HOLOSCAN_LOG_WARN("adaptive_batch needs max_batch_latency_us; using fixed batches");
+    } else {
+      adaptive_ = true;
+      HOLOSCAN_LOG_INFO("Network RX operator sizing batches between {} and {} packets",
+                        std::clamp(min_batch_size_.get(), 1U, batch_size_.get()),
+                        batch_size_.get());
+    }
+  }
+}
 
+void BasicNetworkOpRx::InitSocket() {
+  if (l4_proto_ == L4Proto::UDP) {
     if ((sockfd_ = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP)) < 0) {
       HOLOSCAN_LOG_CRITICAL("Failed to create UDP socket");
       throw;
     }
   } else {
-    l4_proto_ = L4Proto::TCP;
-
     if ((sockfd_ = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP)) < 0) {
       HOLOSCAN_LOG_CRITICAL("Failed to create TCP socket");
       throw;
@@ -73,7 +318,6 @@ void BasicNetworkOpRx::initialize() {
     }
   }
 
-
   if (bind(sockfd_, reinterpret_cast<const struct sockaddr*>(&server_addr_),
       sizeof(server_addr_)) < 0) {
     HOLOSCAN_LOG_CRITICAL("Failed to bind to {}:{}!", ip_addr_.get(), port_.get());
@@ -89,53 +333,573 @@ void BasicNetworkOpRx::initialize() {
   }
 }
 
+void BasicNetworkOpRx::InitUring(int fd) {
+  // The kernel receives into max_payload_size slots of the burst buffers, one per packet
+  uring_rx_ = NetworkUringRx::Create(fd, pool_, io_uring_entries_.get(), batch_size_.get(),
+                                     max_payload_size_.get());
+  if (uring_rx_ == nullptr) {
+    HOLOSCAN_LOG_WARN("io_uring is unavailable; falling back to socket receive");
+    io_backend_ = IoBackend::SOCKET;
+    return;
+  }
+
+  HOLOSCAN_LOG_INFO("Network RX operator using io_uring with about {} receive slots",
+                    io_uring_entries_.get());
+}
+
+void BasicNetworkOpRx::InitTimestamps() {
+  // Shards enable timestamps on their own sockets. io_uring and TCP receives carry no control
+  // data, so those packets are stamped when the operator reads them.
+  if (!shards_.empty()) {
+    kernel_ts_ = true;
+  } else if (l4_proto_ == L4Proto::UDP && uring_rx_ == nullptr) {
+    kernel_ts_ = EnableRxTimestamps(sockfd_, ts_mode_, server_addr_) != RxTimestampMode::NONE;
+  } else {
+    HOLOSCAN_LOG_WARN("Kernel receive timestamps need UDP socket receive; packets are stamped "
+                      "when read");
+  }
+
+  if (kernel_ts_) {
+    const size_t words = RX_TS_CTRL_SIZE / sizeof(uint64_t);
+    ts_ctrl_.resize(std::max<size_t>(msgs_.size(), 1) * words);
+    for (size_t i = 0; i < msgs_.size(); i++) {
+      msgs_[i].msg_hdr.msg_control = &ts_ctrl_[i * words];
+    }
+  }
+
+  HOLOSCAN_LOG_INFO("Network RX operator recording {} receive timestamps",
+                    kernel_ts_ ? "kernel" : "user space");
+}
+
+void BasicNetworkOpRx::InitPoll() {
+  if ((epfd_ = epoll_create1(EPOLL_CLOEXEC)) < 0) {
+    HOLOSCAN_LOG_CRITICAL("Failed to create epoll set");
+    throw;
+  }
+
+  // Wait on whatever the received packets come from. TCP adds its socket once a client connects.
+  if (!shards_.empty()) {
+    if ((wake_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)) < 0) {
+      HOLOSCAN_LOG_CRITICAL("Failed to create eventfd for RX shards");
+      throw;
+    }
+
+    for (auto &shard : shards_) {
+      shard->SetWakeFd(wake_fd_);
+    }
+
+    AddPollFd(wake_fd_);
+  } else if (uring_rx_ != nullptr) {
+    AddPollFd(uring_rx_->PollFd());
+  } else if (l4_proto_ == L4Proto::UDP) {
+    AddPollFd(sockfd_);
+  }
+
+  HOLOSCAN_LOG_INFO("Network RX operator waiting up to {}ms for packets", poll_timeout_ms_.get());
+}
+
+void BasicNetworkOpRx::AddPollFd(int fd) {
+  struct epoll_event ev;
+  memset(&ev, 0, sizeof(ev));
+  ev.events = EPOLLIN;
+  ev.data.fd = fd;
+  if (epoll_ctl(epfd_, EPOLL_CTL_ADD, fd, &ev) < 0) {
+    HOLOSCAN_LOG_CRITICAL("Failed to add file descriptor to epoll set");
+    throw;
+  }
+}
+
+bool BasicNetworkOpRx::WaitForData() {
+  // Stream bytes already read past a wrong length guess would not wake the wait
+  if (carry_pos_ < carry_.size()) {
+    return true;
+  }
+
+  // Shards only signal the eventfd once asked to, and a shard that already has packets needs no
+  // wait at all
+  bool ready = false;
+  for (auto &shard : shards_) {
+    ready |= shard->ArmWake();
+  }
+
+  if (ready) {
+    return true;
+  }
+
+  // Never sleep past the partial batch deadline. Less than a millisecond left is polled out.
+  int timeout_ms = poll_timeout_ms_.get();
+  if (max_batch_latency_us_.get() > 0 && pkts_in_batch_ > 0) {
+    const uint64_t deadline_ns = batch_start_ns_ + max_batch_latency_us_.get() * 1000ULL;
+    const uint64_t now = NowNs();
+    const uint64_t left_ms = deadline_ns > now ? (deadline_ns - now) / 1000000 : 0;
+    if (left_ms == 0) {
+      return false;
+    }
+
+    timeout_ms = std::min<uint64_t>(timeout_ms, left_ms);
+  }
+
+  poll_waits_++;
+
+  struct epoll_event ev;
+  if (epoll_wait(epfd_, &ev, 1, timeout_ms) <= 0) {
+    poll_timeouts_++;
+    return false;
+  }
+
+  if (wake_fd_ >= 0) {
+    uint64_t cnt;
+    if (read(wake_fd_, &cnt, sizeof(cnt)) < 0 && errno != EAGAIN) {
+      HOLOSCAN_LOG_ERROR("Failed to read RX shard eventfd");
+    }
+  }
+
+  return true;
+}
+
+void BasicNetworkOpRx::InitShards() {
+  const auto &cpus = shard_cpus_.get();
+  for (uint32_t s = 0; s < num_shards_.get(); s++) {
+    const int cpu = s < cpus.size() ? cpus[s] : -1;
+    shards_.push_back(std::make_unique<NetworkRxShard>(s, server_addr_, cpu,
+        shard_ring_size_.get(), max_payload_size_.get(), batch_size_.get(), ts_mode_));
+  }
+
+  // Start workers only once every socket is bound so no shard misses early flows
+  for (auto &shard : shards_) {
+    shard->Start();
+  }
+
+  HOLOSCAN_LOG_INFO("Network RX operator bound {} SO_REUSEPORT shards to {}:{}",
+                    shards_.size(), ip_addr_.get(), port_.get());
+}
+
+std::vector<NetworkRxShardStats> BasicNetworkOpRx::GetShardStats() const {
+  std::vector<NetworkRxShardStats> stats;
+  for (const auto &shard : shards_) {
+    stats.push_back(shard->Stats());
+  }
+
+  return stats;
+}
+
+void BasicNetworkOpRx::PopShards() {
+  // Visit shards round robin, starting one past the last shard visited, so a busy shard cannot
+  // starve the others
+  for (size_t visited = 0; visited < shards_.size(); visited++) {
+    if (pkts_in_batch_ == batch_target_) {
+      return;
+    }
+
+    auto &shard = shards_[next_shard_];
+    next_shard_ = (next_shard_ + 1) % shards_.size();
+    pkts_in_batch_ += shard->Pop(&pkt_buf[byte_cnt_], &pkt_lens_[pkts_in_batch_],
+                                 batch_target_ - pkts_in_batch_, byte_cnt_,
+                                 pkt_ts_ != nullptr ? &pkt_ts_[pkts_in_batch_] : nullptr);
+  }
+}
+
+bool BasicNetworkOpRx::AllocBurstBuffer() {
+  // io_uring bursts start wherever the kernel will receive next, which may be part way through a
+  // buffer the previous burst also uses. Lengths and timestamps are per slot in either case.
+  uint32_t first_slot = 0;
+  if (uring_rx_ != nullptr) {
+    if (!uring_rx_->BeginBurst(burst_buf_, first_slot)) {
+      return false;
+    }
+  } else {
+    burst_buf_ = pool_->Get();
+    if (!burst_buf_) {
+      return false;
+    }
+  }
+
+  pkt_buf = burst_buf_.data() + static_cast<size_t>(first_slot) * max_payload_size_.get();
+  pkt_lens_ = reinterpret_cast<uint32_t*>(burst_buf_.data() + pkt_lens_offset_) + first_slot;
+  if (ts_mode_ != RxTimestampMode::NONE) {
+    pkt_ts_ = reinterpret_cast<uint64_t*>(burst_buf_.data() + pkt_ts_offset_) + first_slot;
+  }
+
+  return true;
+}
+
+void BasicNetworkOpRx::DropPackets() {
+  // Bound the work per call so a flood of packets cannot stall the operator. With io_uring every
+  // slot is in a burst downstream, so the receive has stopped and the socket is read directly.
+  if (!shards_.empty()) {
+    uint32_t len;
+    for (uint32_t p = 0; p < batch_size_.get(); p++) {
+      uint32_t bytes = 0;
+      if (shards_[next_shard_]->Pop(drop_buf_.data(), &len, 1, bytes) == 1) { dropped_pkts_++; }
+      next_shard_ = (next_shard_ + 1) % shards_.size();
+    }
+
+    return;
+  }
+
+  const int fd = (l4_proto_ == L4Proto::TCP) ? tcp_sock_ : sockfd_;
+  for (uint32_t p = 0; p < batch_size_.get(); p++) {
+    if (recv(fd, drop_buf_.data(), drop_buf_.size(), MSG_DONTWAIT) < 0) {
+      return;
+    }
+
+    dropped_pkts_++;
+  }
+}
+
+int BasicNetworkOpRx::RecvSingle() {
+  int n;
+  sockaddr_in addr;
+  socklen_t from_len = sizeof(addr);
+
+  if (kernel_ts_) {
+    struct iovec iov = {&pkt_buf[byte_cnt_], max_payload_size_.get()};
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = ts_ctrl_.data();
+    msg.msg_controllen = RX_TS_CTRL_SIZE;
+    n = recvmsg(sockfd_, &msg, MSG_DONTWAIT);
+    if (n > 0) { pkt_ts_[pkts_in_batch_] = ParseRxTimestamp(msg); }
+  } else if (l4_proto_ == L4Proto::UDP) {
+    n = recvfrom(sockfd_,
+                &pkt_buf[byte_cnt_],
+                max_payload_size_.get(),
+                MSG_DONTWAIT,
+                (sockaddr*)&addr,
+                &from_len);
+  } else {
+    n = recv(tcp_sock_,
+                &pkt_buf[byte_cnt_],
+                max_payload_size_.get(),
+                0);
+  }
+
+  if (n > 0) {
+    pkt_lens_[pkts_in_batch_++] = n;
+    byte_cnt_ += n;
+  }
+
+  return n;
+}
+
+int BasicNetworkOpRx::RecvBatch() {
+  const uint32_t to_recv = batch_target_ - pkts_in_batch_;
+  const uint16_t max_payload = max_payload_size_.get();
+
+  // Each datagram lands in its own max_payload_size slot starting at the current write offset
+  for (uint32_t i = 0; i < to_recv; i++) {
+    iovs_[i].iov_base = &pkt_buf[byte_cnt_ + i * max_payload];
+    if (kernel_ts_) { msgs_[i].msg_hdr.msg_controllen = RX_TS_CTRL_SIZE; }
+  }
+
+  int n = recvmmsg(sockfd_, msgs_.data(), to_recv, MSG_DONTWAIT, nullptr);
+  if (n <= 0) {
+    return n;
+  }
+
+  // Pack datagrams back to back. Nothing moves when every datagram fills its slot.
+  for (int i = 0; i < n; i++) {
+    auto len = msgs_[i].msg_len;
+    auto src = static_cast<uint8_t*>(iovs_[i].iov_base);
+    if (src != &pkt_buf[byte_cnt_]) {
+      memmove(&pkt_buf[byte_cnt_], src, len);
+    }
+
+    if (kernel_ts_) { pkt_ts_[pkts_in_batch_] = ParseRxTimestamp(msgs_[i].msg_hdr); }
+    pkt_lens_[pkts_in_batch_++] = len;
+    byte_cnt_ += len;
+  }
+
+  return n;
+}
+
+int BasicNetworkOpRx::RecvFramed() {
+  // Bytes read past a wrong length guess are used before reading more of the stream
+  if (carry_pos_ < carry_.size()) {
+    ParseCarry();
+    return 1;
+  }
+
+  const uint32_t batch = batch_target_;
+  uint32_t pkts = pkts_in_batch_;
+  uint32_t pos = byte_cnt_;
+  size_t num_iovs = 0;
+  size_t num_hdrs = 0;
+
+  auto add_iov = [&](void *base, size_t len) {
+    frame_iovs_[num_iovs].iov_base = base;
+    frame_iovs_[num_iovs++].iov_len = len;
+  };
+
+  // Finish the current message, then guess that the rest of the batch repeats the last length. If
+  // the guess holds, every payload lands in its final place in the burst buffer.
+  const bool starts_with_hdr = frame_hdr_have_ < FRAME_HDR_SIZE;
+  if (!starts_with_hdr) {
+    add_iov(&pkt_buf[pos + frame_have_], frame_len_ - frame_have_);
+    pos += frame_len_;
+    pkts++;
+  }
+
+  while (pkts < batch && num_iovs + 2 <= frame_iovs_.size()) {
+    const size_t hdr_len = (num_iovs == 0) ? FRAME_HDR_SIZE - frame_hdr_have_ : FRAME_HDR_SIZE;
+    add_iov(&frame_hdrs_[num_hdrs++ * FRAME_HDR_SIZE], hdr_len);
+    add_iov(&pkt_buf[pos], next_frame_len_);
+    pos += next_frame_len_;
+    pkts++;
+  }
+
+  ssize_t n = readv(tcp_sock_, frame_iovs_.data(), num_iovs);
+  if (n <= 0) {
+    return n;
+  }
+
+  size_t left = n;
+  bool is_hdr = starts_with_hdr;
+  for (size_t i = 0; i < num_iovs && left > 0; i++, is_hdr = !is_hdr) {
+    const auto base = static_cast<uint8_t*>(frame_iovs_[i].iov_base);
+    const auto len = std::min(left, frame_iovs_[i].iov_len);
+    left -= len;
+
+    if (!is_hdr) {
+      frame_have_ += len;
+      if (len > 0 && frame_have_ == frame_len_) { CompleteFrame(); }
+      continue;
+    }
+
+    memcpy(&frame_hdr_[frame_hdr_have_], base, len);
+    frame_hdr_have_ += len;
+    if (frame_hdr_have_ < FRAME_HDR_SIZE) {
+      break;
+    }
+
+    StartFrame();
+
+    // A wrong guess means everything read after this header is out of place. Copy it out of the
+    // burst buffer before parsing it into the right place.
+    if (left > 0 && frame_iovs_[i + 1].iov_len != frame_len_) {
+      for (size_t j = i + 1; j < num_iovs && left > 0; j++) {
+        const auto src = static_cast<uint8_t*>(frame_iovs_[j].iov_base);
+        const auto cnt = std::min(left, frame_iovs_[j].iov_len);
+        carry_.insert(carry_.end(), src, src + cnt);
+        left -= cnt;
+      }
+
+      ParseCarry();
+      break;
+    }
+  }
+
+  return n;
+}
+
+void BasicNetworkOpRx::ParseCarry() {
+  while (carry_pos_ < carry_.size() && pkts_in_batch_ < batch_target_) {
+    const size_t avail = carry_.size() - carry_pos_;
+    const uint8_t *src = &carry_[carry_pos_];
+
+    if (frame_hdr_have_ < FRAME_HDR_SIZE) {
+      const auto len = std::min<size_t>(avail, FRAME_HDR_SIZE - frame_hdr_have_);
+      memcpy(&frame_hdr_[frame_hdr_have_], src, len);
+      frame_hdr_have_ += len;
+      carry_pos_ += len;
+      if (frame_hdr_have_ == FRAME_HDR_SIZE) { StartFrame(); }
+    } else {
+      const auto len = std::min<size_t>(avail, frame_len_ - frame_have_);
+      memcpy(&pkt_buf[byte_cnt_ + frame_have_], src, len);
+      frame_have_ += len;
+      carry_pos_ += len;
+      if (frame_have_ == frame_len_) { CompleteFrame(); }
+    }
+  }
+
+  if (carry_pos_ == carry_.size()) {
+    carry_.clear();
+    carry_pos_ = 0;
+  }
+}
+
+void BasicNetworkOpRx::StartFrame() {
+  uint32_t len;
+  memcpy(&len, frame_hdr_, sizeof(len));
+  frame_len_ = ntohl(len);
+  frame_have_ = 0;
+
+  // Every message must fit in its slot of the burst buffer
+  if (frame_len_ > max_payload_size_.get()) {
+    HOLOSCAN_LOG_CRITICAL("Received a {} byte message, larger than max_payload_size {}",
+                          frame_len_, max_payload_size_.get());
+    throw;
+  }
+
+  next_frame_len_ = frame_len_;
+  if (frame_len_ == 0) { CompleteFrame(); }
+}
+
+void BasicNetworkOpRx::CompleteFrame() {
+  pkt_lens_[pkts_in_batch_++] = frame_len_;
+  byte_cnt_ += frame_len_;
+  frame_hdr_have_ = 0;
+  frame_have_ = 0;
+}
+
+bool BasicNetworkOpRx::FillBurst() {
+  const bool was_empty = pkts_in_batch_ == 0;
+  const uint32_t first_pkt = pkts_in_batch_;
+
+  if (uring_rx_ != nullptr) {
+    // Completions are read from shared memory, so this makes no system call unless the multishot
+    // receive needs re-arming
+    pkts_in_batch_ += uring_rx_->Harvest(&pkt_lens_[pkts_in_batch_],
+                                         batch_target_ - pkts_in_batch_, byte_cnt_);
+  } else if (!shards_.empty()) {
+    PopShards();
+  } else {
+    while (pkts_in_batch_ < batch_target_) {
+      int n;
+      if (framing_ == Framing::LENGTH_PREFIX) {
+        n = RecvFramed();
+      } else {
+        n = (recv_mode_ == RecvMode::BATCH) ? RecvBatch() : RecvSingle();
+      }
+
+      if (n <= 0) {
+        break;
+      }
+    }
+  }
+
+  if (pkt_ts_ != nullptr) {
+    StampPackets(first_pkt);
+  }
+
+  if (was_empty && pkts_in_batch_ > 0 && max_batch_latency_us_.get() > 0) {
+    batch_start_ns_ = NowNs();
+  }
+
+  // An io_uring burst also ends with its buffer, since the next slots are in another one
+  return pkts_in_batch_ == batch_target_ || (uring_rx_ != nullptr && uring_rx_->BurstFull());
+}
+
+void BasicNetworkOpRx::StampPackets(uint32_t first_pkt) {
+  // Packets without a kernel timestamp get the time they were read. This is later than the kernel
+  // received them by however long they sat in the socket queue.
+  const uint64_t now = RealtimeNs();
+  for (uint32_t p = first_pkt; p < pkts_in_batch_; p++) {
+    if (!kernel_ts_ || pkt_ts_[p] == 0) { pkt_ts_[p] = now; }
+  }
+}
+
+bool BasicNetworkOpRx::BatchExpired() const {
+  return max_batch_latency_us_.get() > 0 && pkts_in_batch_ > 0 &&
+         NowNs() - batch_start_ns_ >= max_batch_latency_us_.get() * 1000ULL;
+}
+
+void BasicNetworkOpRx::UpdateBatchTarget(bool expired) {
+  // Packets per nanosecond over the batch just emitted. A full batch that filled instantly says
+  // nothing about the rate beyond "high", so it counts as filling in a microsecond.
+  const uint64_t elapsed_ns = std::max<uint64_t>(NowNs() - batch_start_ns_, 1000);
+  const double rate = static_cast<double>(pkts_in_batch_) / elapsed_ns;
+  arrival_rate_ = (arrival_rate_ == 0) ? rate : arrival_rate_ + (rate - arrival_rate_) / 8;
+
+  // Aim for the packets expected within the latency budget. Expired batches shrink the target
+  // straight away rather than waiting for the average to catch up. The estimate is capped before
+  // the conversion, since a high rate over a long budget can exceed what a uint32_t holds.
+  auto target = static_cast<uint32_t>(std::min<double>(
+      arrival_rate_ * max_batch_latency_us_.get() * 1000, batch_size_.get()));
+  if (expired) {
+    target = std::min(target, pkts_in_batch_);
+  }
+
+  batch_target_ = std::clamp(target, std::clamp(min_batch_size_.get(), 1U, batch_size_.get()),
+                             batch_size_.get());
+}
+
+void BasicNetworkOpRx::RequeuePartialFrame() {
+  // The partial message is read again into the next burst, so put its header and payload back in
+  // front of any unparsed bytes
+  std::vector<uint8_t> carry(frame_hdr_, frame_hdr_ + frame_hdr_have_);
+  if (frame_hdr_have_ == FRAME_HDR_SIZE) {
+    carry.insert(carry.end(), &pkt_buf[byte_cnt_], &pkt_buf[byte_cnt_ + frame_have_]);
+  }
+
+  carry.insert(carry.end(), carry_.begin() + carry_pos_, carry_.end());
+  carry_ = std::move(carry);
+  carry_pos_ = 0;
+  frame_hdr_have_ = 0;
+  frame_have_ = 0;
+}
+
 void BasicNetworkOpRx::compute([[maybe_unused]] InputContext&, OutputContext& op_output,
                                [[maybe_unused]] ExecutionContext&) {
   HOLOSCAN_LOG_DEBUG("BasicNetworkOpRx::compute");
-  sockaddr_in addr;
-  socklen_t from_len;
-  from_len = sizeof(addr);
 
   if (l4_proto_ == L4Proto::TCP && !connected_) {
     HOLOSCAN_LOG_INFO("Waiting for incoming TCP connection on {}:{}", ip_addr_.get(), port_.get());
-    if ((tcp_sock_ = accept(sockfd_, (struct sockaddr*)&server_addr_,
-                            (socklen_t*)&server_addr_)) < 0) {
+    struct sockaddr_in client_addr;
+    socklen_t client_len = sizeof(client_addr);
+    if ((tcp_sock_ = accept(sockfd_, reinterpret_cast<struct sockaddr*>(&client_addr),
+                            &client_len)) < 0) {
         HOLOSCAN_LOG_CRITICAL("Failed to accept incoming TCP connection");
         throw;
     }
 
     HOLOSCAN_LOG_INFO("Successfully attached to incoming connection");
     connected_ = true;
+
+    if (io_backend_ == IoBackend::IO_URING) { InitUring(tcp_sock_); }
+    if (epfd_ >= 0) {
+      // Reads must not block so a partial batch returns to the epoll wait and its timeout
+      fcntl(tcp_sock_, F_SETFL, fcntl(tcp_sock_, F_GETFL) | O_NONBLOCK);
+      AddPollFd(uring_rx_ != nullptr ? uring_rx_->PollFd() : tcp_sock_);
+    }
   }
 
-  if (byte_cnt_ == 0) { pkt_buf = new uint8_t[max_payload_size_.get() * batch_size_.get()]; }
+  if (pkt_buf == nullptr && !AllocBurstBuffer()) {
+    // Every buffer is still held downstream
+    pool_empty_cnt_++;
+    if (pool_full_policy_ == PoolFullPolicy::DROP) { DropPackets(); }
+    return;
+  }
 
-  while (pkts_in_batch_ < batch_size_.get()) {
-    int n;
+  // Without a poll timeout compute() returns straight away when the batch is not full, so the
+  // scheduler ticks it again immediately
+  bool full = FillBurst();
+  if (!full && epfd_ >= 0 && !BatchExpired() && WaitForData()) {
+    full = FillBurst();
+  }
 
-    if (l4_proto_ == L4Proto::UDP) {
-      n = recvfrom(sockfd_,
-                  &pkt_buf[byte_cnt_],
-                  max_payload_size_.get(),
-                  MSG_DONTWAIT,
-                  (sockaddr*)&addr,
-                  &from_len);
-    } else if (l4_proto_ == L4Proto::TCP) {
-      n = recv(tcp_sock_,
-                  &pkt_buf[byte_cnt_],
-                  max_payload_size_.get(),
-                  0);
-    }
+  const bool expired = !full && BatchExpired();
+  if (!full && !expired) {
+    return;
+  }
 
-    if (n > 0) {
-      byte_cnt_ += n;
-      pkts_in_batch_++;
-    } else {
-      return;
+  if (expired) {
+    partial_flushes_++;
+    if (framing_ == Framing::LENGTH_PREFIX && frame_hdr_have_ > 0) {
+      RequeuePartialFrame();
     }
   }
 
-  auto msg = std::make_shared<NetworkOpBurstParams>(pkt_buf, byte_cnt_, pkts_in_batch_);
+  if (adaptive_) {
+    UpdateBatchTarget(expired);
+  }
+
+  auto msg = std::make_shared<NetworkOpBurstParams>(
+      std::move(burst_buf_), byte_cnt_, pkts_in_batch_, pkt_lens_);
+  if (uring_rx_ != nullptr) {
+    msg->data = pkt_buf;
+    msg->pkt_stride = max_payload_size_.get();
+  }
+  if (pkt_ts_ != nullptr) {
+    msg->pkt_ts = pkt_ts_;
+    msg->emit_ts = RealtimeNs();
+  }
+
+  pkt_buf = nullptr;
+  pkt_lens_ = nullptr;
+  pkt_ts_ = nullptr;
   byte_cnt_ = 0;
   pkts_in_batch_ = 0;
 
@@ -19,8 +19,13 @@
 #include <arpa/inet.h>
 #include <netinet/in.h>
 #include <sys/socket.h>
+#include <memory>
 #include <string>
+#include <vector>
+#include "basic_network_io_uring.h"
 #include "basic_network_operator_common.h"
+#include "basic_network_rx_shard.h"
+#include "basic_network_rx_timestamp.h"
 #include "holoscan/holoscan.hpp"
 
 namespace holoscan::ops {
@@ -35,21 +40,108 @@ class BasicNetworkOpRx : public Operator {
   void setup(OperatorSpec& spec) override;
   void compute(InputContext&, OutputContext& op_output, ExecutionContext&) override;
 
+  /**
+   * @brief Get the counters of each RX shard
+   *
+   * @return One entry per shard. Empty if sharded receive is not enabled
+   */
+  std::vector<NetworkRxShardStats> GetShardStats() const;
+
  private:
+  void InitSocket();
+  void InitShards();
+  void InitUring(int fd);
+  void InitTimestamps();
+  void InitPoll();
+  void AddPollFd(int fd);
+  bool WaitForData();
+  bool FillBurst();
+  void StampPackets(uint32_t first_pkt);
+  bool BatchExpired() const;
+  void UpdateBatchTarget(bool expired);
+  void RequeuePartialFrame();
+  void PopShards();
+  bool AllocBurstBuffer();
+  void DropPackets();
+  int RecvSingle();
+  int RecvBatch();
+  int RecvFramed();
+  void ParseCarry();
+  void StartFrame();
+  void CompleteFrame();
+
   Parameter<std::string> ip_addr_;
   Parameter<uint16_t> port_;
   Parameter<std::string> l4_proto_p_;
   Parameter<uint32_t> batch_size_;
   Parameter<uint16_t> max_payload_size_;
+  Parameter<std::string> recv_mode_p_;
+  Parameter<uint32_t> buffer_pool_size_;
+  Parameter<std::string> pool_full_policy_p_;
+  Parameter<uint32_t> num_shards_;
+  Parameter<std::vector<int>> shard_cpus_;
+  Parameter<uint32_t> shard_ring_size_;
+  Parameter<std::string> io_backend_p_;
+  Parameter<uint32_t> io_uring_entries_;
+  Parameter<std::string> framing_p_;
+  Parameter<uint32_t> poll_timeout_ms_;
+  Parameter<uint32_t> max_batch_latency_us_;
+  Parameter<bool> adaptive_batch_;
+  Parameter<uint32_t> min_batch_size_;
+  Parameter<std::string> rx_timestamps_p_;
 
   int sockfd_;
   int tcp_sock_;
   L4Proto l4_proto_;
+  RecvMode recv_mode_;
+  IoBackend io_backend_ = IoBackend::SOCKET;
+  Framing framing_ = Framing::NONE;
+  PoolFullPolicy pool_full_policy_;
   struct sockaddr_in server_addr_;
   uint32_t byte_cnt_ = 0;
-  uint8_t* pkt_buf = nullptr;
+  std::shared_ptr<NetworkBufferPool> pool_;
+  NetworkBuffer burst_buf_;       // Buffer currently being filled
+  uint8_t* pkt_buf = nullptr;     // Data pointer of burst_buf_
+  uint32_t* pkt_lens_ = nullptr;
+  size_t pkt_lens_offset_ = 0;
+  uint64_t* pkt_ts_ = nullptr;    // Receive times, after the lengths, when timestamps are on
+  size_t pkt_ts_offset_ = 0;
+  RxTimestampMode ts_mode_ = RxTimestampMode::NONE;
+  bool kernel_ts_ = false;        // Packets are stamped by the kernel rather than when read
+  std::vector<uint64_t> ts_ctrl_;  // Control data buffer for each packet of a receive call
   uint32_t pkts_in_batch_ = 0;
   bool connected_ = false;
+  uint64_t pool_empty_cnt_ = 0;   // compute() calls that found no free buffer
+  uint64_t dropped_pkts_ = 0;     // Packets discarded under the drop policy
+  std::vector<uint8_t> drop_buf_;
+  std::vector<std::unique_ptr<NetworkRxShard>> shards_;
+  size_t next_shard_ = 0;         // Shard PopShards() visits first
+  std::unique_ptr<NetworkUringRx> uring_rx_;
+  int epfd_ = -1;                 // epoll set compute() waits on when poll_timeout_ms is set
+  int wake_fd_ = -1;              // eventfd shards signal when they receive packets
+  uint64_t poll_waits_ = 0;       // Times compute() waited for packets
+  uint64_t poll_timeouts_ = 0;    // Waits that ended without packets
+  uint32_t batch_target_ = 0;     // Packets per emitted burst; below batch_size when adaptive
+  bool adaptive_ = false;
+  uint64_t batch_start_ns_ = 0;   // When the first packet of the current burst was received
+  double arrival_rate_ = 0;       // Average packets per nanosecond, for adaptive batching
+  uint64_t partial_flushes_ = 0;  // Bursts emitted short because max_batch_latency_us passed
+
+  // Preassembled recvmmsg() descriptors, one per packet in a batch
+  std::vector<struct mmsghdr> msgs_;
+  std::vector<struct iovec> iovs_;
+
+  // Length-prefixed TCP reassembly. Payloads are read straight into the burst buffer by guessing
+  // that each message is as long as the last one; bytes read past a wrong guess go to carry_.
+  uint8_t frame_hdr_[FRAME_HDR_SIZE];
+  uint32_t frame_hdr_have_ = 0;   // Header bytes of the current message received so far
+  uint32_t frame_len_ = 0;        // Payload length of the current message
+  uint32_t frame_have_ = 0;       // Payload bytes of the current message received so far
+  uint32_t next_frame_len_ = 0;   // Guessed payload length of messages not yet seen
+  std::vector<uint8_t> frame_hdrs_;  // Landing space for the headers of guessed messages
+  std::vector<struct iovec> frame_iovs_;
+  std::vector<uint8_t> carry_;
+  size_t carry_pos_ = 0;
 };
 
 };  // namespace holoscan::ops
@@ -14,13 +14,149 @@
  * limitations under the License.
  */
 
+#include <errno.h>
+#include <ifaddrs.h>
+#include <linux/net_tstamp.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <net/if.h>
+#include <netinet/udp.h>
+#include <limits.h>
+#include <poll.h>
+#include <string.h>
+#include <sys/uio.h>
 #include <unistd.h>
 #include <algorithm>
 #include <string>
 #include "basic_network_operator_tx.h"
 
+#ifndef UDP_SEGMENT
+#define UDP_SEGMENT 103
+#endif
+
+#ifndef SO_TXTIME
+#define SO_TXTIME 61
+#define SCM_TXTIME SO_TXTIME
+#endif
+
 namespace holoscan::ops {
 
+// Kernel limits on a single UDP GSO send
+static constexpr uint32_t UDP_GSO_MAX_SEGS  = 64;
+static constexpr uint32_t UDP_GSO_MAX_BYTES = 65507;
+
+// How long to wait for socket buffer space before retrying a send
+static constexpr int RETRY_POLL_MS = 1;
+
+// Waits shorter than this are spun rather than slept, since wakeup latency is larger
+static constexpr uint64_t PACING_SPIN_NS = 20000;
+
+// Space for one SCM_TXTIME control message, in uint64_t words to keep it aligned
+static constexpr size_t TXTIME_CTRL_WORDS = (CMSG_SPACE(sizeof(uint64_t)) + 7) / 8;
+
+static bool IsRetryable(int err) {
+  return err == EAGAIN || err == EWOULDBLOCK || err == ENOBUFS;
+}
+
+static uint64_t ClockNs(clockid_t clock) {
+  struct timespec ts;
+  clock_gettime(clock, &ts);
+  return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + ts.tv_nsec;
+}
+
+// Index of the interface packets to dst leave from, found from the source address the kernel picks
+static unsigned int EgressIfIndex(const struct sockaddr_in &dst) {
+  int fd = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+  if (fd < 0) { return 0; }
+
+  struct sockaddr_in src = {};
+  socklen_t src_len = sizeof(src);
+  const bool routed =
+      connect(fd, reinterpret_cast<const struct sockaddr*>(&dst), sizeof(dst)) == 0 &&
+      getsockname(fd, reinterpret_cast<struct sockaddr*>(&src), &src_len) == 0;
+  close(fd);
+  if (!routed) { return 0; }
+
+  struct ifaddrs *ifas;
+  if (getifaddrs(&ifas) != 0) { return 0; }
+
+  unsigned int ifindex = 0;
+  for (auto ifa = ifas; ifa != nullptr && ifindex == 0; ifa = ifa->ifa_next) {
+    if (ifa->ifa_addr != nullptr && ifa->ifa_addr->sa_family == AF_INET &&
+        reinterpret_cast<struct sockaddr_in*>(ifa->ifa_addr)->sin_addr.s_addr ==
+            src.sin_addr.s_addr) {
+      ifindex = if_nametoindex(ifa->ifa_name);
+    }
+  }
+
+  freeifaddrs(ifas);
+  return ifindex;
+}
+
+// Whether a qdisc of the given kind is installed anywhere on an interface, such as fq under mq.
+// SO_TXTIME is accepted on any socket, but launch times are ignored without one of these qdiscs.
+static bool HasQdisc(unsigned int ifindex, const char *kind) {
+  int fd = socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_ROUTE);
+  if (fd < 0) { return false; }
+
+  struct {
+    struct nlmsghdr nlh;
+    struct tcmsg tcm;
+  } req = {};
+  req.nlh.nlmsg_len = NLMSG_LENGTH(sizeof(req.tcm));
+  req.nlh.nlmsg_type = RTM_GETQDISC;
+  req.nlh.nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP;
+  req.tcm.tcm_family = AF_UNSPEC;
+  if (send(fd, &req, req.nlh.nlmsg_len, 0) < 0) {
+    close(fd);
+    return false;
+  }
+
+  std::vector<uint32_t> buf(8192);
+  bool found = false;
+  bool done = false;
+  while (!done) {
+    ssize_t len = recv(fd, buf.data(), buf.size() * sizeof(buf[0]), 0);
+    if (len <= 0) { break; }
+
+    auto nlh = reinterpret_cast<struct nlmsghdr*>(buf.data());
+    for (; NLMSG_OK(nlh, len); nlh = NLMSG_NEXT(nlh, len)) {
+      if (nlh->nlmsg_type == NLMSG_DONE || nlh->nlmsg_type == NLMSG_ERROR) {
+        done = true;
+        break;
+      }
+
+      auto tcm = static_cast<struct tcmsg*>(NLMSG_DATA(nlh));
+      if (nlh->nlmsg_type != RTM_NEWQDISC || tcm->tcm_ifindex != static_cast<int>(ifindex)) {
+        continue;
+      }
+
+      int attr_len = nlh->nlmsg_len - NLMSG_LENGTH(sizeof(*tcm));
+      for (auto rta = TCA_RTA(tcm); RTA_OK(rta, attr_len); rta = RTA_NEXT(rta, attr_len)) {
+        if (rta->rta_type == TCA_KIND &&
+            strncmp(static_cast<const char*>(RTA_DATA(rta)), kind, RTA_PAYLOAD(rta)) == 0) {
+          found = true;
+        }
+      }
+    }
+  }
+
+  close(fd);
+  return found;
+}
+
+static void SleepUntilNs(uint64_t target_ns) {
+  auto now = ClockNs(CLOCK_MONOTONIC);
+  if (target_ns > now + PACING_SPIN_NS) {
+    auto wake_ns = target_ns - PACING_SPIN_NS;
+    struct timespec ts = {static_cast<time_t>(wake_ns / 1000000000ULL),
+                          static_cast<long>(wake_ns % 1000000000ULL)};
+    clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr);
+  }
+
+  while (ClockNs(CLOCK_MONOTONIC) < target_ns) {}
+}
+
 void BasicNetworkOpTx::setup(OperatorSpec& spec) {
   spec.input<NetworkOpBurstParams>("burst_in");
 
@@ -40,7 +176,65 @@ void BasicNetworkOpTx::setup(OperatorSpec& spec) {
                        "Re-connect() interval",
                        "Interval to retry connecting to server in seconds",
                        1);
+  spec.param<std::string>(tx_mode_p_,
+                          "tx_mode",
+                          "UDP transmit mode",
+                          "single (sendto per packet), batch (sendmmsg per burst), or gso "
+                          "(sendmmsg of UDP_SEGMENT super-datagrams)",
+                          "single");
+  spec.param<uint32_t>(max_retries_,
+                       "max_retries",
+                       "Maximum send retries",
+                       "Consecutive retries when the socket buffer is full before the rest of "
+                       "the burst is dropped",
+                       100);
+  spec.param<std::string>(pacing_p_,
+                          "pacing",
+                          "Pacing mode",
+                          "How min_ipg_ns is enforced: sleep (nanosleep per packet), txtime "
+                          "(SO_TXTIME launch times), or token_bucket (user-space pacer)",
+                          "sleep");
+  spec.param<std::string>(txtime_clock_p_,
+                          "txtime_clock",
+                          "SO_TXTIME clock",
+                          "Clock for SO_TXTIME launch times: monotonic (fq qdisc) or tai "
+                          "(etf qdisc)",
+                          "monotonic");
+  spec.param<uint32_t>(pacing_burst_,
+                       "pacing_burst",
+                       "Token bucket depth",
+                       "Packets the token bucket pacer may send back to back after idling",
+                       1);
+  spec.param<std::string>(io_backend_p_,
+                          "io_backend",
+                          "I/O backend",
+                          "socket (send calls per burst) or io_uring (asynchronous sends)",
+                          "socket");
+  spec.param<uint32_t>(io_uring_depth_,
+                       "io_uring_depth",
+                       "io_uring queue depth",
+                       "Sends that may be in flight in the io_uring before compute() waits",
+                       256);
+  spec.param<std::string>(framing_p_,
+                          "framing",
+                          "TCP message framing",
+                          "none (raw byte stream) or length_prefix (32-bit length before each "
+                          "message)",
+                          "none");
+}
+
+BasicNetworkOpTx::~BasicNetworkOpTx() {
+  if (uring_tx_ != nullptr) {
+    uring_tx_->Drain();
+    ttl_pkts_sent_ += uring_tx_->NumPktsSent();
+    dropped_pkts_ += uring_tx_->NumPktsFailed();
+    send_calls_ += uring_tx_->NumSubmits();
+  }
+
+  HOLOSCAN_LOG_INFO("TX operator sent {} packets in {} send calls, {} retries, {} packets dropped",
+                    ttl_pkts_sent_, send_calls_, retries_, dropped_pkts_);
 }
+
 void BasicNetworkOpTx::initialize() {
   HOLOSCAN_LOG_INFO("BasicNetworkOpTx::initialize()");
   holoscan::Operator::initialize();
@@ -75,71 +269,362 @@ void BasicNetworkOpTx::initialize() {
     ts_.tv_sec = 0;
     ts_.tv_nsec = ipg_.get();
   }
-}
 
-void BasicNetworkOpTx::compute(InputContext& op_input, [[maybe_unused]] OutputContext& op_output,
-                               [[maybe_unused]] ExecutionContext&) {
-  HOLOSCAN_LOG_DEBUG("BasicNetworkOpTx::compute");
-  auto msg = op_input.receive<NetworkOpBurstParams>("burst_in");
-  int sent;
+  if (ipg_.get() > 0 && pacing_p_.get() != "sleep") {
+    if (l4_proto_ != L4Proto::UDP) {
+      HOLOSCAN_LOG_CRITICAL("Only sleep pacing is supported for TCP");
+      throw;
+    }
 
-  if (!connected_) {
-    auto ret = connect(sockfd_, (struct sockaddr*)&server_addr_, sizeof(server_addr_));
-    if (ret < 0) {
-      if (retry_connect_.get() == -1) {
-        HOLOSCAN_LOG_INFO("Failed to connect to TCP server at {}:{}. Retries disabled.",
-                          ip_addr_.get(), port_.get());
-      }
+    pacing_ = PacingMode::TOKEN_BUCKET;
 
-      if (retry_connect_.get() > 0) {
-        HOLOSCAN_LOG_INFO("Failed to connect to TCP server at {}:{}. Trying again in {}s...",
-                          ip_addr_.get(), port_.get(), retry_connect_.get());
-        sleep(retry_connect_.get());
+    if (pacing_p_.get() == "txtime") {
+      txtime_clock_ = (txtime_clock_p_.get() == "tai") ? CLOCK_TAI : CLOCK_MONOTONIC;
+
+      // fq honours monotonic launch times and etf TAI ones. Without the matching qdisc on the
+      // egress interface packets would leave as soon as they are queued.
+      const char *qdisc = (txtime_clock_ == CLOCK_TAI) ? "etf" : "fq";
+      const auto ifindex = EgressIfIndex(server_addr_);
+      struct sock_txtime txtime_cfg = {txtime_clock_, 0};
+      if (ifindex == 0 || !HasQdisc(ifindex, qdisc)) {
+        HOLOSCAN_LOG_WARN("No {} qdisc on the interface to {}; using token bucket pacing",
+                          qdisc, ip_addr_.get());
+      } else if (setsockopt(sockfd_, SOL_SOCKET, SO_TXTIME, &txtime_cfg, sizeof(txtime_cfg)) < 0) {
+        HOLOSCAN_LOG_WARN("SO_TXTIME is not supported on this system; using token bucket pacing");
+      } else {
+        pacing_ = PacingMode::TXTIME;
       }
+    }
 
-      return;
+    HOLOSCAN_LOG_INFO("Network TX operator pacing packets {}ns apart using {}",
+                      ipg_.get(), pacing_ == PacingMode::TXTIME ? "SO_TXTIME" : "a token bucket");
+
+    // Paced packets are still handed over a burst at a time; launch times or the token bucket
+    // space them, not the number of packets per call
+    msgs_per_call_ = UINT32_MAX;
+  }
+
+  if (tx_mode_p_.get() == "batch" || tx_mode_p_.get() == "gso") {
+    if (l4_proto_ != L4Proto::UDP) {
+      HOLOSCAN_LOG_CRITICAL("Batch and GSO transmit modes are only supported for UDP");
+      throw;
     }
 
-    connected_ = true;
-    HOLOSCAN_LOG_INFO("Successfully connected to server at {}:{}", ip_addr_.get(), port_.get());
+    if (ipg_.get() > 0 && pacing_ == PacingMode::SLEEP) {
+      HOLOSCAN_LOG_WARN("min_ipg_ns is ignored in {} transmit mode with sleep pacing",
+                        tx_mode_p_.get());
+    }
+
+    tx_mode_ = TxMode::BATCH;
+    msgs_per_call_ = UINT32_MAX;
+  } else {
+    tx_mode_ = TxMode::SINGLE;
+  }
+
+  if (tx_mode_p_.get() == "gso" && pacing_ != PacingMode::SLEEP) {
+    // Every segment of a GSO message leaves at the same time, so packets could not be spaced
+    HOLOSCAN_LOG_WARN("GSO cannot be paced; using batch transmit mode");
+  } else if (tx_mode_p_.get() == "gso") {
+    // Every segment except the last in a message is max_payload_size, matching the packets the
+    // single and batch modes produce
+    int gso_size = max_payload_size_.get();
+    if (setsockopt(sockfd_, SOL_UDP, UDP_SEGMENT, &gso_size, sizeof(gso_size)) < 0) {
+      HOLOSCAN_LOG_WARN("UDP GSO is not supported on this system; using batch transmit mode");
+    } else {
+      tx_mode_ = TxMode::GSO;
+      gso_segs_ = std::clamp(UDP_GSO_MAX_BYTES / max_payload_size_.get(), 1U, UDP_GSO_MAX_SEGS);
+    }
+  }
+
+  if (tx_mode_ != TxMode::SINGLE) {
+    HOLOSCAN_LOG_INFO("Network TX operator using sendmmsg with {} packets per message", gso_segs_);
+  }
+
+  if (framing_p_.get() == "length_prefix") {
+    if (l4_proto_ != L4Proto::TCP) {
+      HOLOSCAN_LOG_CRITICAL("Length-prefixed framing is only supported for TCP");
+      throw;
+    }
+
+    if (ipg_.get() > 0) {
+      HOLOSCAN_LOG_WARN("min_ipg_ns is ignored with length-prefixed framing");
+    }
+
+    framing_ = Framing::LENGTH_PREFIX;
+  }
+
+  if (io_backend_p_.get() == "io_uring") {
+    if (framing_ == Framing::LENGTH_PREFIX) {
+      HOLOSCAN_LOG_WARN("io_uring does not support length-prefixed framing; using socket transmit");
+    } else {
+      io_backend_ = IoBackend::IO_URING;
+      if (pacing_ != PacingMode::SLEEP || ipg_.get() > 0) {
+        HOLOSCAN_LOG_WARN("min_ipg_ns is ignored with the io_uring backend");
+      }
+    }
+  }
+}
+
+uint32_t BasicNetworkOpTx::TakeTokens(uint32_t wanted) {
+  const uint64_t ipg = ipg_.get();
+  auto now = ClockNs(CLOCK_MONOTONIC);
+
+  // Idle time earns at most pacing_burst packets of credit. Oversleeping below is not clamped, so
+  // late wakeups are made up by sending the packets that fell due in the meantime.
+  const uint64_t max_lag = ipg * (std::max(pacing_burst_.get(), 1U) - 1);
+  if (now > tb_next_ns_ + max_lag) { tb_next_ns_ = now - max_lag; }
+
+  if (now < tb_next_ns_) {
+    SleepUntilNs(tb_next_ns_);
+    now = ClockNs(CLOCK_MONOTONIC);
+  }
+
+  auto tokens = static_cast<uint32_t>(std::min<uint64_t>(wanted, (now - tb_next_ns_) / ipg + 1));
+  tb_next_ns_ += tokens * ipg;
+  return tokens;
+}
+
+bool BasicNetworkOpTx::WaitForRetry(uint32_t &retries) {
+  if (retries++ >= max_retries_.get()) {
+    return false;
   }
 
+  retries_++;
 
-  while (msg->len > 0) {
-    auto pkt_size = std::min(msg->len, static_cast<uint32_t>(max_payload_size_.get()));
+  struct pollfd pfd = {sockfd_, POLLOUT, 0};
+  poll(&pfd, 1, RETRY_POLL_MS);
+  return true;
+}
+
+void BasicNetworkOpTx::SendSingle(NetworkOpBurstParams &msg) {
+  const uint32_t max_payload = max_payload_size_.get();
+  uint32_t remaining = msg.len;
+  uint32_t retries = 0;
+  int sent;
+
+  while (remaining > 0) {
+    auto pkt_size = std::min(remaining, max_payload);
     if (l4_proto_ == L4Proto::UDP) {
       sent = sendto(sockfd_,
-                        msg->data + byte_cnt_,
+                        msg.data + byte_cnt_,
                         static_cast<size_t>(pkt_size),
                         MSG_DONTWAIT,
                         reinterpret_cast<const struct sockaddr*>(&server_addr_),
                         sizeof(server_addr_));
-
-      if (sent == -1) {
-        HOLOSCAN_LOG_ERROR("Error while sending UDP packet: {}", errno);
-        continue;
-      }
-    } else if (l4_proto_ == L4Proto::TCP) {
+    } else {
       sent = send(sockfd_,
-                        msg->data + byte_cnt_,
+                        msg.data + byte_cnt_,
                         static_cast<size_t>(pkt_size),
                         MSG_DONTWAIT);
+    }
+
+    send_calls_++;
 
-      if (sent == -1) {
-        HOLOSCAN_LOG_ERROR("Error while sending TCP packet: {}", errno);
+    if (sent == -1) {
+      if (IsRetryable(errno) && WaitForRetry(retries)) {
         continue;
       }
+
+      HOLOSCAN_LOG_ERROR("Error while sending {} packet: {}. Dropping rest of burst",
+                         l4_proto_ == L4Proto::UDP ? "UDP" : "TCP", errno);
+      dropped_pkts_ += (remaining + max_payload - 1) / max_payload;
+      break;
     }
 
-    msg->len -= sent;
+    retries = 0;
+    ttl_pkts_sent_++;
+    remaining -= sent;
     byte_cnt_ += sent;
 
     if (ipg_.get() > 0) { nanosleep(&ts_, nullptr); }
   }
 
   byte_cnt_ = 0;
+}
+
+void BasicNetworkOpTx::SendBatch(NetworkOpBurstParams &msg) {
+  const uint32_t max_payload = max_payload_size_.get();
+  const uint32_t msg_bytes = max_payload * gso_segs_;
+  const uint32_t num_msgs = (msg.len + msg_bytes - 1) / msg_bytes;
 
-  delete[] msg->data;
+  if (msgs_.size() < num_msgs) {
+    msgs_.resize(num_msgs);
+    iovs_.resize(num_msgs);
+    ctrl_.resize(pacing_ == PacingMode::TXTIME ? num_msgs * TXTIME_CTRL_WORDS : 0);
+    for (uint32_t m = 0; m < num_msgs; m++) {
+      memset(&msgs_[m], 0, sizeof(msgs_[m]));
+      msgs_[m].msg_hdr.msg_iov = &iovs_[m];
+      msgs_[m].msg_hdr.msg_iovlen = 1;
+
+      if (pacing_ == PacingMode::TXTIME) {
+        msgs_[m].msg_hdr.msg_control = &ctrl_[m * TXTIME_CTRL_WORDS];
+        msgs_[m].msg_hdr.msg_controllen = CMSG_SPACE(sizeof(uint64_t));
+        auto cmsg = CMSG_FIRSTHDR(&msgs_[m].msg_hdr);
+        cmsg->cmsg_level = SOL_SOCKET;
+        cmsg->cmsg_type = SCM_TXTIME;
+        cmsg->cmsg_len = CMSG_LEN(sizeof(uint64_t));
+      }
+    }
+  }
+
+  // Same segmentation as the single mode: max_payload_size packets with a short final packet
+  for (uint32_t m = 0; m < num_msgs; m++) {
+    iovs_[m].iov_base = msg.data + m * msg_bytes;
+    iovs_[m].iov_len = std::min(msg_bytes, msg.len - m * msg_bytes);
+  }
+
+  if (pacing_ == PacingMode::TXTIME) {
+    // Launch times carry on from the previous burst so the spacing holds across bursts
+    next_launch_ns_ = std::max(next_launch_ns_, ClockNs(txtime_clock_));
+    for (uint32_t m = 0; m < num_msgs; m++) {
+      auto launch_ns = next_launch_ns_ + static_cast<uint64_t>(m) * ipg_.get();
+      memcpy(CMSG_DATA(CMSG_FIRSTHDR(&msgs_[m].msg_hdr)), &launch_ns, sizeof(launch_ns));
+    }
+
+    next_launch_ns_ += static_cast<uint64_t>(num_msgs) * ipg_.get();
+  }
+
+  uint32_t done = 0;
+  uint32_t retries = 0;
+  while (done < num_msgs) {
+    auto count = std::min(num_msgs - done, msgs_per_call_);
+    if (pacing_ == PacingMode::TOKEN_BUCKET) { count = TakeTokens(count); }
+
+    int n = sendmmsg(sockfd_, &msgs_[done], count, MSG_DONTWAIT);
+    send_calls_++;
+
+    // Give back tokens for anything the kernel did not take
+    if (pacing_ == PacingMode::TOKEN_BUCKET) {
+      tb_next_ns_ -= static_cast<uint64_t>(count - std::max(n, 0)) * ipg_.get();
+    }
+
+    if (n < 0) {
+      if (IsRetryable(errno) && WaitForRetry(retries)) {
+        continue;
+      }
+
+      HOLOSCAN_LOG_ERROR("Error while sending UDP packets: {}. Dropping rest of burst", errno);
+      dropped_pkts_ += (msg.len - done * msg_bytes + max_payload - 1) / max_payload;
+      break;
+    }
+
+    for (int m = 0; m < n; m++) {
+      ttl_pkts_sent_ += (iovs_[done + m].iov_len + max_payload - 1) / max_payload;
+    }
+
+    retries = 0;
+    done += n;
+  }
+}
+
+void BasicNetworkOpTx::SendFramed(NetworkOpBurstParams &msg) {
+  const uint32_t max_payload = max_payload_size_.get();
+
+  // Message boundaries come from pkt_lens when the producer set them. Otherwise the burst is split
+  // into max_payload_size messages, the same as the unframed modes.
+  const uint32_t num_pkts = (msg.pkt_lens != nullptr) ? msg.num_pkts
+                                                      : (msg.len + max_payload - 1) / max_payload;
+  if (frame_hdrs_.size() < num_pkts) {
+    frame_hdrs_.resize(num_pkts);
+    frame_iovs_.resize(2 * num_pkts);
+  }
+
+  uint32_t offset = 0;
+  for (uint32_t p = 0; p < num_pkts; p++) {
+    const uint32_t len = (msg.pkt_lens != nullptr) ? msg.pkt_lens[p]
+                                                   : std::min(max_payload, msg.len - offset);
+    frame_hdrs_[p] = htonl(len);
+    frame_iovs_[2 * p].iov_base = &frame_hdrs_[p];
+    frame_iovs_[2 * p].iov_len = FRAME_HDR_SIZE;
+    frame_iovs_[2 * p + 1].iov_base = msg.data + offset;
+    frame_iovs_[2 * p + 1].iov_len = len;
+    offset += len;
+  }
+
+  // writev() takes at most IOV_MAX descriptors and may stop part way through one, so each call
+  // resumes where the last one stopped
+  const size_t num_iovs = 2 * static_cast<size_t>(num_pkts);
+  size_t iov = 0;
+  uint32_t retries = 0;
+  while (iov < num_iovs) {
+    ssize_t sent = writev(sockfd_, &frame_iovs_[iov], std::min<size_t>(num_iovs - iov, IOV_MAX));
+    send_calls_++;
+
+    if (sent < 0) {
+      if (IsRetryable(errno) && WaitForRetry(retries)) {
+        continue;
+      }
+
+      HOLOSCAN_LOG_ERROR("Error while sending framed TCP burst: {}. Dropping rest of burst", errno);
+      dropped_pkts_ += (num_iovs - iov + 1) / 2;
+      break;
+    }
+
+    retries = 0;
+    while (iov < num_iovs && static_cast<size_t>(sent) >= frame_iovs_[iov].iov_len) {
+      sent -= frame_iovs_[iov].iov_len;
+      if (iov % 2 == 1) { ttl_pkts_sent_++; }
+      iov++;
+    }
+
+    if (sent > 0) {
+      frame_iovs_[iov].iov_base = static_cast<uint8_t*>(frame_iovs_[iov].iov_base) + sent;
+      frame_iovs_[iov].iov_len -= sent;
+    }
+  }
+}
+
+void BasicNetworkOpTx::compute(InputContext& op_input, [[maybe_unused]] OutputContext& op_output,
+                               [[maybe_unused]] ExecutionContext&) {
+  HOLOSCAN_LOG_DEBUG("BasicNetworkOpTx::compute");
+  auto msg = op_input.receive<NetworkOpBurstParams>("burst_in");
+
+  if (msg->pkt_stride != 0) {
+    HOLOSCAN_LOG_ERROR("Bursts with a packet stride cannot be sent. Dropping burst");
+    return;
+  }
+
+  if (!connected_) {
+    auto ret = connect(sockfd_, (struct sockaddr*)&server_addr_, sizeof(server_addr_));
+    if (ret < 0) {
+      if (retry_connect_.get() == -1) {
+        HOLOSCAN_LOG_INFO("Failed to connect to TCP server at {}:{}. Retries disabled.",
+                          ip_addr_.get(), port_.get());
+      }
+
+      if (retry_connect_.get() > 0) {
+        HOLOSCAN_LOG_INFO("Failed to connect to TCP server at {}:{}. Trying again in {}s...",
+                          ip_addr_.get(), port_.get(), retry_connect_.get());
+        sleep(retry_connect_.get());
+      }
+
+      return;
+    }
+
+    connected_ = true;
+    HOLOSCAN_LOG_INFO("Successfully connected to server at {}:{}", ip_addr_.get(), port_.get());
+
+    if (io_backend_ == IoBackend::IO_URING) {
+      // Sends are submitted without an address, so the engine needs the connected socket
+      uring_tx_ = NetworkUringTx::Create(sockfd_, io_uring_depth_.get());
+      if (uring_tx_ == nullptr) {
+        HOLOSCAN_LOG_WARN("io_uring is unavailable; falling back to socket transmit");
+        io_backend_ = IoBackend::SOCKET;
+      }
+    }
+  }
+
+  if (uring_tx_ != nullptr) {
+    // The engine holds the burst until every send completes, so its buffer is not recycled early.
+    // With GSO each send carries gso_segs packets.
+    uring_tx_->Send(msg, max_payload_size_.get() * gso_segs_, max_payload_size_.get());
+  } else if (framing_ == Framing::LENGTH_PREFIX) {
+    SendFramed(*msg);
+  } else if (tx_mode_ == TxMode::SINGLE && pacing_ == PacingMode::SLEEP) {
+    SendSingle(*msg);
+  } else {
+    SendBatch(*msg);
+  }
 
   HOLOSCAN_LOG_DEBUG("BasicNetworkOpTx::compute done");
 }
@@ -19,7 +19,11 @@
 #include <arpa/inet.h>
 #include <netinet/in.h>
 #include <sys/socket.h>
+#include <time.h>
+#include <memory>
 #include <string>
+#include <vector>
+#include "basic_network_io_uring.h"
 #include "basic_network_operator_common.h"
 #include "holoscan/holoscan.hpp"
 
@@ -30,26 +34,62 @@ class BasicNetworkOpTx : public Operator {
   HOLOSCAN_OPERATOR_FORWARD_ARGS(BasicNetworkOpTx);
 
   BasicNetworkOpTx() = default;
-  ~BasicNetworkOpTx() = default;
+  ~BasicNetworkOpTx();
   void initialize() override;
   void setup(OperatorSpec& spec) override;
   void compute(InputContext&, OutputContext& op_output, ExecutionContext&) override;
 
  private:
+  void SendSingle(NetworkOpBurstParams &msg);
+  void SendBatch(NetworkOpBurstParams &msg);
+  void SendFramed(NetworkOpBurstParams &msg);
+  bool WaitForRetry(uint32_t &retries);
+  uint32_t TakeTokens(uint32_t wanted);
+
   Parameter<std::string> ip_addr_;
   Parameter<uint16_t> port_;
   Parameter<int32_t> retry_connect_;
   Parameter<std::string> l4_proto_p_;
   Parameter<uint16_t> max_payload_size_;
   Parameter<uint32_t> ipg_;
+  Parameter<std::string> tx_mode_p_;
+  Parameter<uint32_t> max_retries_;
+  Parameter<std::string> pacing_p_;
+  Parameter<std::string> txtime_clock_p_;
+  Parameter<uint32_t> pacing_burst_;
+  Parameter<std::string> io_backend_p_;
+  Parameter<uint32_t> io_uring_depth_;
+  Parameter<std::string> framing_p_;
 
   int sockfd_;
   L4Proto l4_proto_;
+  TxMode tx_mode_;
+  PacingMode pacing_ = PacingMode::SLEEP;
+  IoBackend io_backend_ = IoBackend::SOCKET;
+  Framing framing_ = Framing::NONE;
+  clockid_t txtime_clock_ = CLOCK_MONOTONIC;
   struct sockaddr_in server_addr_;
   uint32_t byte_cnt_ = 0;
-  uint32_t pkts_sent_ = 0;
   struct timespec ts_;
   bool connected_ = false;
+  uint32_t gso_segs_ = 1;          // Packets carried by each sendmmsg() message
+  uint32_t msgs_per_call_ = 1;     // Messages passed to each sendmmsg() call
+  uint64_t next_launch_ns_ = 0;    // SO_TXTIME launch time of the next packet
+  uint64_t tb_next_ns_ = 0;        // Earliest time the token bucket may send the next packet
+  uint64_t ttl_pkts_sent_ = 0;     // Packets handed to the kernel
+  uint64_t send_calls_ = 0;        // Send syscalls issued
+  uint64_t retries_ = 0;           // Sends retried after the socket buffer filled up
+  uint64_t dropped_pkts_ = 0;      // Packets abandoned after max_retries or a send error
+
+  // sendmmsg() descriptors, grown to fit the largest burst seen
+  std::vector<struct mmsghdr> msgs_;
+  std::vector<struct iovec> iovs_;
+  std::vector<uint64_t> ctrl_;     // SCM_TXTIME control messages, one per descriptor
+  std::unique_ptr<NetworkUringTx> uring_tx_;
+
+  // writev() descriptors for length-prefixed framing: a header and a payload per message
+  std::vector<uint32_t> frame_hdrs_;
+  std::vector<struct iovec> frame_iovs_;
 };
 
 };  // namespace holoscan::ops
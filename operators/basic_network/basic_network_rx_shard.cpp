@@ -0,0 +1,205 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <pthread.h>
+#include <sched.h>
+#include <string.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <algorithm>
+#include "basic_network_rx_shard.h"
+#include "basic_network_rx_timestamp.h"
+#include "holoscan/holoscan.hpp"
+
+namespace holoscan::ops {
+
+// How often a blocked worker wakes up to check whether it should exit
+static constexpr int SHARD_RECV_TIMEOUT_US = 100000;
+
+NetworkRxShard::NetworkRxShard(uint32_t id, const struct sockaddr_in &addr, int cpu,
+                               uint32_t ring_size, uint16_t max_payload, uint32_t batch_size,
+                               RxTimestampMode ts_mode)
+    : id_(id), cpu_(cpu), batch_size_(batch_size) {
+  uint32_t slots = 1;
+  while (slots < ring_size) { slots <<= 1; }
+  mask_ = slots - 1;
+
+  slot_size_ = (max_payload + CACHE_LINE_SIZE - 1) & ~(CACHE_LINE_SIZE - 1);
+  slots_ = std::make_unique<uint8_t[]>(slot_size_ * slots);
+  lens_ = std::make_unique<uint32_t[]>(slots);
+
+  msgs_.resize(batch_size);
+  iovs_.resize(batch_size);
+  for (uint32_t i = 0; i < batch_size; i++) {
+    iovs_[i].iov_len = max_payload;
+    memset(&msgs_[i], 0, sizeof(msgs_[i]));
+    msgs_[i].msg_hdr.msg_iov = &iovs_[i];
+    msgs_[i].msg_hdr.msg_iovlen = 1;
+  }
+
+  if ((sockfd_ = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP)) < 0) {
+    HOLOSCAN_LOG_CRITICAL("Failed to create UDP socket for RX shard {}", id_);
+    throw;
+  }
+
+  // Every shard sets SO_REUSEPORT before binding so the kernel balances flows across them
+  int opt = 1;
+  if (setsockopt(sockfd_, SOL_SOCKET, SO_REUSEPORT, &opt, sizeof(opt)) < 0) {
+    HOLOSCAN_LOG_CRITICAL("Failed to set SO_REUSEPORT on RX shard {}", id_);
+    throw;
+  }
+
+  struct timeval tv = {0, SHARD_RECV_TIMEOUT_US};
+  if (setsockopt(sockfd_, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv)) < 0) {
+    HOLOSCAN_LOG_CRITICAL("Failed to set receive timeout on RX shard {}", id_);
+    throw;
+  }
+
+  if (bind(sockfd_, reinterpret_cast<const struct sockaddr*>(&addr), sizeof(addr)) < 0) {
+    HOLOSCAN_LOG_CRITICAL("Failed to bind RX shard {}", id_);
+    throw;
+  }
+
+  if (ts_mode != RxTimestampMode::NONE &&
+      EnableRxTimestamps(sockfd_, ts_mode, addr) != RxTimestampMode::NONE) {
+    ts_ = std::make_unique<uint64_t[]>(slots);
+    ts_ctrl_.resize(batch_size * RX_TS_CTRL_SIZE / sizeof(uint64_t));
+    for (uint32_t i = 0; i < batch_size; i++) {
+      msgs_[i].msg_hdr.msg_control = &ts_ctrl_[i * RX_TS_CTRL_SIZE / sizeof(uint64_t)];
+    }
+  }
+}
+
+NetworkRxShard::~NetworkRxShard() {
+  stop_.store(true);
+  if (worker_.joinable()) {
+    worker_.join();
+  }
+
+  if (sockfd_ >= 0) {
+    close(sockfd_);
+  }
+}
+
+void NetworkRxShard::Start() {
+  worker_ = std::thread(&NetworkRxShard::Run, this);
+}
+
+void NetworkRxShard::Run() {
+  if (cpu_ >= 0) {
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    CPU_SET(cpu_, &cpuset);
+    if (pthread_setaffinity_np(pthread_self(), sizeof(cpuset), &cpuset) != 0) {
+      HOLOSCAN_LOG_ERROR("Failed to pin RX shard {} to CPU {}", id_, cpu_);
+    }
+  }
+
+  HOLOSCAN_LOG_INFO("RX shard {} started on CPU {}", id_, sched_getcpu());
+
+  const uint32_t ring_size = mask_ + 1;
+  bool waiting = false;   // The ring was full on the last pass, so this wait is already counted
+  while (!stop_.load(std::memory_order_relaxed)) {
+    const auto tail = tail_.load(std::memory_order_relaxed);
+    const auto head = head_.load(std::memory_order_acquire);
+    const uint32_t free_slots = ring_size - (tail - head);
+    if (free_slots == 0) {
+      if (!waiting) { ring_full_.fetch_add(1, std::memory_order_relaxed); }
+      waiting = true;
+      std::this_thread::yield();
+      continue;
+    }
+
+    waiting = false;
+
+    // Receive straight into the ring, stopping at the wrap so each packet is one slot
+    const uint32_t to_recv =
+        std::min({free_slots, ring_size - (tail & mask_), batch_size_});
+    for (uint32_t i = 0; i < to_recv; i++) {
+      iovs_[i].iov_base = Slot(tail + i);
+      if (ts_ != nullptr) { msgs_[i].msg_hdr.msg_controllen = RX_TS_CTRL_SIZE; }
+    }
+
+    // Block for the first packet only, then take whatever else is already queued
+    int n = recvmmsg(sockfd_, msgs_.data(), to_recv, MSG_WAITFORONE, nullptr);
+    if (n <= 0) {
+      continue;
+    }
+
+    uint64_t bytes = 0;
+    for (int i = 0; i < n; i++) {
+      lens_[(tail + i) & mask_] = msgs_[i].msg_len;
+      bytes += msgs_[i].msg_len;
+      if (ts_ != nullptr) { ts_[(tail + i) & mask_] = ParseRxTimestamp(msgs_[i].msg_hdr); }
+    }
+
+    tail_.store(tail + n, std::memory_order_release);
+    pkts_.fetch_add(n, std::memory_order_relaxed);
+    bytes_.fetch_add(bytes, std::memory_order_relaxed);
+    recv_calls_.fetch_add(1, std::memory_order_relaxed);
+
+    // Pairs with the fence in ArmWake() so either the operator sees the new tail or the worker
+    // sees the wake request
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (wake_armed_.load(std::memory_order_relaxed) &&
+        wake_armed_.exchange(false, std::memory_order_acquire)) {
+      const uint64_t one = 1;
+      if (write(wake_fd_, &one, sizeof(one)) < 0) {
+        HOLOSCAN_LOG_ERROR("RX shard {} failed to signal the operator", id_);
+      }
+    }
+  }
+}
+
+bool NetworkRxShard::ArmWake() {
+  wake_armed_.store(true, std::memory_order_release);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  return tail_.load(std::memory_order_relaxed) != head_.load(std::memory_order_relaxed);
+}
+
+uint32_t NetworkRxShard::Pop(uint8_t *dst, uint32_t *lens, uint32_t max_pkts, uint32_t &bytes,
+                             uint64_t *ts) {
+  const auto head = head_.load(std::memory_order_relaxed);
+  const auto tail = tail_.load(std::memory_order_acquire);
+  const uint32_t n = std::min(tail - head, max_pkts);
+
+  uint32_t offset = 0;
+  for (uint32_t i = 0; i < n; i++) {
+    const auto len = lens_[(head + i) & mask_];
+    memcpy(dst + offset, Slot(head + i), len);
+    lens[i] = len;
+    offset += len;
+    if (ts != nullptr) { ts[i] = (ts_ != nullptr) ? ts_[(head + i) & mask_] : 0; }
+  }
+
+  bytes += offset;
+
+  head_.store(head + n, std::memory_order_release);
+  return n;
+}
+
+NetworkRxShardStats NetworkRxShard::Stats() const {
+  return {id_,
+          cpu_,
+          pkts_.load(std::memory_order_relaxed),
+          bytes_.load(std::memory_order_relaxed),
+          recv_calls_.load(std::memory_order_relaxed),
+          ring_full_.load(std::memory_order_relaxed),
+          tail_.load(std::memory_order_relaxed) - head_.load(std::memory_order_relaxed)};
+}
+
+};  // namespace holoscan::ops
@@ -0,0 +1,134 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <stdint.h>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "basic_network_operator_common.h"
+
+namespace holoscan::ops {
+
+/**
+ * @brief Counters for a single RX shard
+ *
+ */
+struct NetworkRxShardStats {
+  uint32_t id;
+  int cpu;                  // CPU the worker is pinned to, or -1 if not pinned
+  uint64_t pkts;            // Packets received from the socket
+  uint64_t bytes;           // Bytes received from the socket
+  uint64_t recv_calls;      // recvmmsg() calls that returned packets
+  uint64_t ring_full;       // Times the worker found the ring full and had to wait
+  uint32_t ring_occupancy;  // Packets waiting in the ring when the stats were read
+};
+
+/**
+ * @brief One socket of a sharded UDP receiver
+ *
+ * Each shard binds its own SO_REUSEPORT socket to the shared address, so the kernel spreads flows
+ * across shards by hash. A worker thread, optionally pinned to a CPU, drains the socket with
+ * recvmmsg() directly into the slots of a single-producer, single-consumer ring. The operator's
+ * compute thread is the only consumer and copies packets out with Pop().
+ */
+class NetworkRxShard {
+ public:
+  /**
+   * @brief Create and bind the shard's socket. The worker is not started until Start().
+   *
+   * @param id Shard index, used in logs and stats
+   * @param addr Address to bind to
+   * @param cpu CPU to pin the worker to, or -1 to leave it unpinned
+   * @param ring_size Number of packet slots in the ring. Rounded up to a power of two
+   * @param max_payload Largest packet that will be received
+   * @param batch_size Most packets received by a single recvmmsg() call
+   * @param ts_mode Kernel receive timestamps to record with each packet
+   */
+  NetworkRxShard(uint32_t id, const struct sockaddr_in &addr, int cpu, uint32_t ring_size,
+                 uint16_t max_payload, uint32_t batch_size,
+                 RxTimestampMode ts_mode = RxTimestampMode::NONE);
+  ~NetworkRxShard();
+
+  NetworkRxShard(const NetworkRxShard &) = delete;
+  NetworkRxShard &operator=(const NetworkRxShard &) = delete;
+
+  void Start();
+
+  /**
+   * @brief Copy packets out of the ring, packed back to back
+   *
+   * @param dst Destination for the packet data
+   * @param lens Destination for the length of each packet
+   * @param max_pkts Most packets to copy
+   * @param bytes Incremented by the number of bytes copied
+   * @param ts Destination for the receive time of each packet, or nullptr. 0 if not stamped
+   * @return Number of packets copied
+   */
+  uint32_t Pop(uint8_t *dst, uint32_t *lens, uint32_t max_pkts, uint32_t &bytes,
+               uint64_t *ts = nullptr);
+
+  NetworkRxShardStats Stats() const;
+
+  /**
+   * @brief Set the eventfd the worker signals when woken with ArmWake()
+   */
+  void SetWakeFd(int efd) { wake_fd_ = efd; }
+
+  /**
+   * @brief Ask the worker to signal the wake eventfd the next time it adds packets to the ring
+   *
+   * @return true if the ring already holds packets, so there is no need to wait for the signal
+   */
+  bool ArmWake();
+
+ private:
+  static constexpr size_t CACHE_LINE_SIZE = 64;
+
+  void Run();
+  uint8_t *Slot(uint32_t idx) const { return &slots_[(idx & mask_) * slot_size_]; }
+
+  uint32_t id_;
+  int cpu_;
+  int sockfd_ = -1;
+  uint32_t mask_;
+  size_t slot_size_;
+  uint32_t batch_size_;
+  std::unique_ptr<uint8_t[]> slots_;
+  std::unique_ptr<uint32_t[]> lens_;
+  std::unique_ptr<uint64_t[]> ts_;         // Receive time of each slot when timestamps are on
+  std::vector<uint64_t> ts_ctrl_;          // Control data buffer for each message
+  std::vector<struct mmsghdr> msgs_;
+  std::vector<struct iovec> iovs_;
+  std::thread worker_;
+  std::atomic<bool> stop_{false};
+  int wake_fd_ = -1;
+
+  alignas(CACHE_LINE_SIZE) std::atomic<uint32_t> head_{0};   // Next slot to consume
+  alignas(CACHE_LINE_SIZE) std::atomic<uint32_t> tail_{0};   // Next slot to fill
+  alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> pkts_{0};
+  std::atomic<uint64_t> bytes_{0};
+  std::atomic<uint64_t> recv_calls_{0};
+  std::atomic<uint64_t> ring_full_{0};
+  std::atomic<bool> wake_armed_{false};
+};
+
+};  // namespace holoscan::ops
@@ -0,0 +1,126 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <errno.h>
+#include <ifaddrs.h>
+#include <linux/net_tstamp.h>
+#include <linux/sockios.h>
+#include <net/if.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <time.h>
+#include "basic_network_rx_timestamp.h"
+#include "holoscan/holoscan.hpp"
+
+namespace holoscan::ops {
+
+// Turn on receive timestamping in the NIC with the address the socket is bound to
+static bool EnableNicTimestamps(int sockfd, const struct sockaddr_in &addr) {
+  struct ifaddrs *ifas;
+  if (getifaddrs(&ifas) < 0) {
+    return false;
+  }
+
+  bool enabled = false;
+  for (auto ifa = ifas; ifa != nullptr; ifa = ifa->ifa_next) {
+    if (ifa->ifa_addr == nullptr || ifa->ifa_addr->sa_family != AF_INET ||
+        reinterpret_cast<struct sockaddr_in*>(ifa->ifa_addr)->sin_addr.s_addr !=
+            addr.sin_addr.s_addr) {
+      continue;
+    }
+
+    struct hwtstamp_config config;
+    memset(&config, 0, sizeof(config));
+    config.tx_type = HWTSTAMP_TX_OFF;
+    config.rx_filter = HWTSTAMP_FILTER_ALL;
+
+    struct ifreq ifr;
+    memset(&ifr, 0, sizeof(ifr));
+    strncpy(ifr.ifr_name, ifa->ifa_name, IFNAMSIZ - 1);
+    ifr.ifr_data = reinterpret_cast<char*>(&config);
+    if (ioctl(sockfd, SIOCSHWTSTAMP, &ifr) < 0) {
+      HOLOSCAN_LOG_WARN("{} does not support hardware receive timestamps: {}", ifa->ifa_name,
+                        strerror(errno));
+    } else {
+      HOLOSCAN_LOG_INFO("Enabled hardware receive timestamps on {}", ifa->ifa_name);
+      enabled = true;
+    }
+
+    break;
+  }
+
+  freeifaddrs(ifas);
+  return enabled;
+}
+
+RxTimestampMode EnableRxTimestamps(int sockfd, RxTimestampMode mode,
+                                   const struct sockaddr_in &addr) {
+  if (mode == RxTimestampMode::HARDWARE) {
+    // Software stamps are requested too so packets the NIC skips still carry a time
+    if (EnableNicTimestamps(sockfd, addr)) {
+      int flags = SOF_TIMESTAMPING_RX_HARDWARE | SOF_TIMESTAMPING_RAW_HARDWARE |
+                  SOF_TIMESTAMPING_RX_SOFTWARE | SOF_TIMESTAMPING_SOFTWARE;
+      if (setsockopt(sockfd, SOL_SOCKET, SO_TIMESTAMPING, &flags, sizeof(flags)) == 0) {
+        return RxTimestampMode::HARDWARE;
+      }
+
+      HOLOSCAN_LOG_WARN("Failed to enable SO_TIMESTAMPING: {}", strerror(errno));
+    }
+
+    HOLOSCAN_LOG_WARN("Falling back to software receive timestamps");
+  }
+
+  int opt = 1;
+  if (setsockopt(sockfd, SOL_SOCKET, SO_TIMESTAMPNS, &opt, sizeof(opt)) < 0) {
+    HOLOSCAN_LOG_ERROR("Failed to enable SO_TIMESTAMPNS: {}", strerror(errno));
+    return RxTimestampMode::NONE;
+  }
+
+  return RxTimestampMode::SOFTWARE;
+}
+
+uint64_t ParseRxTimestamp(const struct msghdr &msg) {
+  for (auto cmsg = CMSG_FIRSTHDR(&msg); cmsg != nullptr;
+       cmsg = CMSG_NXTHDR(const_cast<struct msghdr*>(&msg), cmsg)) {
+    if (cmsg->cmsg_level != SOL_SOCKET) {
+      continue;
+    }
+
+    const struct timespec *ts = nullptr;
+    if (cmsg->cmsg_type == SCM_TIMESTAMPNS) {
+      ts = reinterpret_cast<const struct timespec*>(CMSG_DATA(cmsg));
+    } else if (cmsg->cmsg_type == SCM_TIMESTAMPING) {
+      // ts[0] is the software stamp and ts[2] the raw hardware stamp. Unset stamps are zero.
+      auto stamps = reinterpret_cast<const struct scm_timestamping*>(CMSG_DATA(cmsg))->ts;
+      ts = (stamps[2].tv_sec != 0 || stamps[2].tv_nsec != 0) ? &stamps[2] : &stamps[0];
+    } else {
+      continue;
+    }
+
+    return static_cast<uint64_t>(ts->tv_sec) * 1000000000ULL + ts->tv_nsec;
+  }
+
+  return 0;
+}
+
+uint64_t RealtimeNs() {
+  struct timespec ts;
+  clock_gettime(CLOCK_REALTIME, &ts);
+  return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + ts.tv_nsec;
+}
+
+};  // namespace holoscan::ops
@@ -0,0 +1,61 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <linux/errqueue.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "basic_network_operator_common.h"
+
+namespace holoscan::ops {
+
+// Control data space for one received timestamp. A multiple of 8 bytes so per-packet control
+// buffers can sit back to back in a uint64_t array.
+constexpr size_t RX_TS_CTRL_SIZE = (CMSG_SPACE(sizeof(struct scm_timestamping)) + 7) & ~size_t(7);
+
+/**
+ * @brief Ask the kernel to timestamp every packet received on a socket
+ *
+ * SOFTWARE enables SO_TIMESTAMPNS, stamped when the packet enters the network stack. HARDWARE
+ * enables SO_TIMESTAMPING and turns on receive timestamping in the NIC that owns addr, keeping the
+ * software stamp for packets the NIC does not timestamp.
+ *
+ * @param sockfd Socket to enable timestamps on
+ * @param mode Timestamps requested
+ * @param addr Address the socket is bound to, used to find the NIC for hardware timestamps
+ * @return Timestamps actually enabled. HARDWARE falls back to SOFTWARE if the NIC refuses
+ */
+RxTimestampMode EnableRxTimestamps(int sockfd, RxTimestampMode mode,
+                                   const struct sockaddr_in &addr);
+
+/**
+ * @brief Receive time of a packet from the control data returned with it
+ *
+ * @param msg Header passed to recvmsg() or recvmmsg()
+ * @return Time in nanoseconds, preferring a hardware stamp, or 0 if the packet has none
+ */
+uint64_t ParseRxTimestamp(const struct msghdr &msg);
+
+/**
+ * @brief Current CLOCK_REALTIME time in nanoseconds, the clock software receive stamps use
+ */
+uint64_t RealtimeNs();
+
+};  // namespace holoscan::ops